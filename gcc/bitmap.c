@@ -57,6 +57,7 @@ static void bitmap_element_link (bitmap, bitmap_element *);
 static bitmap_element *bitmap_elt_insert_after (bitmap, bitmap_element *, unsigned int);
 static void bitmap_elt_clear_from (bitmap, bitmap_element *);
 static bitmap_element *bitmap_find_bit (bitmap, unsigned int);
+static void bitmap_tree_listify (bitmap);
 
 
 /* Add ELEM to the appropriate freelist.  */
@@ -214,13 +215,17 @@ bitmap_elt_clear_from (bitmap head, bitmap_element *elt)
     }
 }
 
-/* Clear a bitmap by freeing the linked list.  */
+/* Clear a bitmap by freeing the linked list.  A bitmap in tree view
+   stays in tree view.  */
 
 void
 bitmap_clear (bitmap head)
 {
-  if (head->first)
-    bitmap_elt_clear_from (head, head->first);
+  if (head->first == NULL)
+    return;
+  if (head->tree_form)
+    bitmap_tree_listify (head);
+  bitmap_elt_clear_from (head, head->first);
 }
 
 /* Initialize a bitmap obstack.  If BIT_OBSTACK is NULL, initialize
@@ -434,6 +439,249 @@ bitmap_elt_insert_after (bitmap head, bitmap_element *elt, unsigned int indx)
   return node;
 }
 
+
+/* Splay tree view.  In tree view the elements of a bitmap form a splay
+   tree ordered by index, rooted at HEAD->first, with the PREV and NEXT
+   fields of each element pointing to its left and right children.  */
+
+/* Splay the tree rooted at T around INDX, so that the element with
+   index INDX, or else the last element visited while looking for it,
+   becomes the root.  Return the new root.  This is the top-down splay
+   of Sleator and Tarjan.  */
+
+static bitmap_element *
+bitmap_tree_splay (bitmap head, bitmap_element *t, unsigned int indx)
+{
+  bitmap_element n, *l, *r;
+
+  if (t == NULL)
+    return NULL;
+
+  bitmap_usage *usage = NULL;
+  if (GATHER_STATISTICS)
+    usage = bitmap_mem_desc.get_descriptor_for_instance (head);
+
+  /* N.NEXT collects the left tree and N.PREV the right tree; L and R
+     are their largest and smallest elements respectively.  */
+  n.prev = n.next = NULL;
+  l = r = &n;
+
+  while (indx != t->indx)
+    {
+      if (GATHER_STATISTICS && usage)
+	usage->m_search_iter++;
+
+      if (indx < t->indx)
+	{
+	  if (t->prev != NULL && indx < t->prev->indx)
+	    {
+	      /* Rotate right.  */
+	      bitmap_element *y = t->prev;
+	      t->prev = y->next;
+	      y->next = t;
+	      t = y;
+	    }
+	  if (t->prev == NULL)
+	    break;
+	  /* Link right.  */
+	  r->prev = t;
+	  r = t;
+	  t = t->prev;
+	}
+      else
+	{
+	  if (t->next != NULL && indx > t->next->indx)
+	    {
+	      /* Rotate left.  */
+	      bitmap_element *y = t->next;
+	      t->next = y->prev;
+	      y->prev = t;
+	      t = y;
+	    }
+	  if (t->next == NULL)
+	    break;
+	  /* Link left.  */
+	  l->next = t;
+	  l = t;
+	  t = t->next;
+	}
+    }
+
+  /* Reassemble.  */
+  l->next = t->prev;
+  r->prev = t->next;
+  t->prev = n.next;
+  t->next = n.prev;
+  return t;
+}
+
+/* Return the element with index INDX in bitmap HEAD, which is in tree
+   view, or NULL if there is none.  Whichever element was looked at last
+   becomes the root.  */
+
+static inline bitmap_element *
+bitmap_tree_find_element (bitmap head, unsigned int indx)
+{
+  if (GATHER_STATISTICS)
+    {
+      bitmap_usage *usage = bitmap_mem_desc.get_descriptor_for_instance (head);
+      if (usage)
+	usage->m_nsearches++;
+    }
+
+  bitmap_element *element = bitmap_tree_splay (head, head->first, indx);
+  head->first = head->current = element;
+  head->indx = element->indx;
+  if (element->indx != indx)
+    element = NULL;
+
+  return element;
+}
+
+/* Insert ELEMENT, whose index must not yet be present, into bitmap HEAD,
+   which is in tree view.  ELEMENT becomes the root.  */
+
+static void
+bitmap_tree_link_element (bitmap head, bitmap_element *element)
+{
+  if (head->first == NULL)
+    element->prev = element->next = NULL;
+  else
+    {
+      bitmap_element *t = bitmap_tree_splay (head, head->first,
+					     element->indx);
+      if (element->indx < t->indx)
+	{
+	  element->prev = t->prev;
+	  element->next = t;
+	  t->prev = NULL;
+	}
+      else
+	{
+	  gcc_checking_assert (element->indx > t->indx);
+	  element->next = t->next;
+	  element->prev = t;
+	  t->next = NULL;
+	}
+    }
+
+  head->first = head->current = element;
+  head->indx = element->indx;
+}
+
+/* Remove ELEMENT, which must be the root, from bitmap HEAD, which is in
+   tree view, and free it.  */
+
+static void
+bitmap_tree_unlink_element (bitmap head, bitmap_element *element)
+{
+  bitmap_element *t;
+
+  gcc_checking_assert (head->first == element);
+
+  /* Bring the largest element of the left subtree to its root; it has
+     no right child, so the right subtree can hang there.  */
+  if (element->prev == NULL)
+    t = element->next;
+  else
+    {
+      t = bitmap_tree_splay (head, element->prev, element->indx);
+      t->next = element->next;
+    }
+
+  head->first = head->current = t;
+  head->indx = t ? t->indx : 0;
+
+  if (GATHER_STATISTICS)
+    register_overhead (head, -((int)sizeof (bitmap_element)));
+
+  bitmap_elem_to_freelist (head, element);
+}
+
+/* Append the elements of the tree rooted at T to ELTS, in ascending
+   order of index.  */
+
+static void
+bitmap_tree_to_vec (vec<bitmap_element *> &elts, bitmap_element *t)
+{
+  auto_vec<bitmap_element *, 32> stack;
+
+  while (true)
+    {
+      for (; t; t = t->prev)
+	stack.safe_push (t);
+      if (stack.is_empty ())
+	break;
+      t = stack.pop ();
+      elts.safe_push (t);
+      t = t->next;
+    }
+}
+
+/* Relink the elements of bitmap HEAD, which is in tree view, into a
+   sorted list.  HEAD->tree_form is left alone.  */
+
+static void
+bitmap_tree_listify (bitmap head)
+{
+  auto_vec<bitmap_element *, 32> elts;
+  unsigned i, n;
+
+  bitmap_tree_to_vec (elts, head->first);
+  n = elts.length ();
+  for (i = 0; i < n; i++)
+    {
+      elts[i]->prev = i > 0 ? elts[i - 1] : NULL;
+      elts[i]->next = i + 1 < n ? elts[i + 1] : NULL;
+    }
+  head->first = n ? elts[0] : NULL;
+}
+
+/* Build a balanced tree from the sorted elements ELTS[LO] to ELTS[HI - 1]
+   and return its root.  */
+
+static bitmap_element *
+bitmap_tree_build (bitmap_element **elts, unsigned lo, unsigned hi)
+{
+  if (lo == hi)
+    return NULL;
+
+  unsigned mid = lo + (hi - lo) / 2;
+  elts[mid]->prev = bitmap_tree_build (elts, lo, mid);
+  elts[mid]->next = bitmap_tree_build (elts, mid + 1, hi);
+  return elts[mid];
+}
+
+/* Switch bitmap HEAD to tree view.  GC-allocated bitmaps are not
+   supported, since the collector walks elements as a list.  */
+
+void
+bitmap_tree_view (bitmap head)
+{
+  auto_vec<bitmap_element *, 32> elts;
+
+  gcc_assert (!head->tree_form && head->obstack);
+
+  for (bitmap_element *ptr = head->first; ptr; ptr = ptr->next)
+    elts.safe_push (ptr);
+
+  head->first = head->current
+    = bitmap_tree_build (elts.address (), 0, elts.length ());
+  head->indx = head->first ? head->first->indx : 0;
+  head->tree_form = true;
+}
+
+/* Switch bitmap HEAD back to the linked-list view.  */
+
+void
+bitmap_list_view (bitmap head)
+{
+  gcc_assert (head->tree_form);
+
+  bitmap_tree_listify (head);
+  head->tree_form = false;
+}
+
 /* Copy a bitmap to another bitmap.  */
 
 void
@@ -442,6 +690,8 @@ bitmap_copy (bitmap to, const_bitmap from)
   const bitmap_element *from_ptr;
   bitmap_element *to_ptr = 0;
 
+  gcc_checking_assert (!to->tree_form && !from->tree_form);
+
   bitmap_clear (to);
 
   /* Copy elements in forward direction one at a time.  */
@@ -477,6 +727,7 @@ void
 bitmap_move (bitmap to, bitmap from)
 {
   gcc_assert (to->obstack == from->obstack);
+  gcc_checking_assert (!to->tree_form && !from->tree_form);
 
   bitmap_clear (to);
 
@@ -506,6 +757,8 @@ bitmap_find_bit (bitmap head, unsigned int bit)
   if (head->current == NULL
       || head->indx == indx)
     return head->current;
+  if (head->tree_form)
+    return bitmap_tree_find_element (head, indx);
   if (head->current == head->first
       && head->first->next == NULL)
     return NULL;
@@ -583,7 +836,12 @@ bitmap_clear_bit (bitmap head, int bit)
 	  /* If we cleared the entire word, free up the element.  */
 	  if (!ptr->bits[word_num]
 	      && bitmap_element_zerop (ptr))
-	    bitmap_element_free (head, ptr);
+	    {
+	      if (head->tree_form)
+		bitmap_tree_unlink_element (head, ptr);
+	      else
+		bitmap_element_free (head, ptr);
+	    }
 	}
 
       return res;
@@ -607,7 +865,10 @@ bitmap_set_bit (bitmap head, int bit)
       ptr = bitmap_element_allocate (head);
       ptr->indx = bit / BITMAP_ELEMENT_ALL_BITS;
       ptr->bits[word_num] = bit_val;
-      bitmap_element_link (head, ptr);
+      if (head->tree_form)
+	bitmap_tree_link_element (head, ptr);
+      else
+	bitmap_element_link (head, ptr);
       return true;
     }
   else
@@ -692,6 +953,7 @@ bitmap_count_bits (const_bitmap a)
   unsigned long count = 0;
   const bitmap_element *elt;
 
+  gcc_checking_assert (!a->tree_form);
   for (elt = a->first; elt; elt = elt->next)
     count += bitmap_count_bits_in_word (elt->bits);
 
@@ -706,6 +968,7 @@ bitmap_count_unique_bits (const_bitmap a, const_bitmap b)
   unsigned long count = 0;
   const bitmap_element *elt_a, *elt_b;
 
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   for (elt_a = a->first, elt_b = b->first; elt_a && elt_b; )
     {
       /* If we're at different indices, then count all the bits
@@ -744,6 +1007,7 @@ bitmap_single_bit_set_p (const_bitmap a)
   const bitmap_element *elt;
   unsigned ix;
 
+  gcc_checking_assert (!a->tree_form);
   if (bitmap_empty_p (a))
     return false;
 
@@ -781,6 +1045,7 @@ bitmap_first_set_bit (const_bitmap a)
   BITMAP_WORD word;
   unsigned ix;
 
+  gcc_checking_assert (!a->tree_form);
   gcc_checking_assert (elt);
   bit_no = elt->indx * BITMAP_ELEMENT_ALL_BITS;
   for (ix = 0; ix != BITMAP_ELEMENT_WORDS; ix++)
@@ -832,6 +1097,7 @@ bitmap_last_set_bit (const_bitmap a)
   BITMAP_WORD word;
   int ix;
 
+  gcc_checking_assert (!a->tree_form);
   gcc_checking_assert (elt);
   while (elt->next)
     elt = elt->next;
@@ -876,6 +1142,7 @@ bitmap_and (bitmap dst, const_bitmap a, const_bitmap b)
   const bitmap_element *b_elt = b->first;
   bitmap_element *dst_prev = NULL;
 
+  gcc_checking_assert (!dst->tree_form && !a->tree_form && !b->tree_form);
   gcc_assert (dst != a && dst != b);
 
   if (a == b)
@@ -934,6 +1201,7 @@ bitmap_and_into (bitmap a, const_bitmap b)
   bitmap_element *next;
   bool changed = false;
 
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   if (a == b)
     return false;
 
@@ -1028,6 +1296,7 @@ bitmap_and_compl (bitmap dst, const_bitmap a, const_bitmap b)
   bitmap_element **dst_prev_pnext = &dst->first;
   bool changed = false;
 
+  gcc_checking_assert (!dst->tree_form && !a->tree_form && !b->tree_form);
   gcc_assert (dst != a && dst != b);
 
   if (a == b)
@@ -1059,17 +1328,19 @@ bitmap_and_compl (bitmap dst, const_bitmap a, const_bitmap b)
 
 	  if (!changed && dst_elt && dst_elt->indx == a_elt->indx)
 	    {
+	      BITMAP_WORD diff = 0;
+
+	      /* Store unconditionally and accumulate the differences, so
+		 that the loop is branch-free and vectorizable.  */
 	      for (ix = 0; ix < BITMAP_ELEMENT_WORDS; ix++)
 		{
 		  BITMAP_WORD r = a_elt->bits[ix] & ~b_elt->bits[ix];
 
-		  if (dst_elt->bits[ix] != r)
-		    {
-		      changed = true;
-		      dst_elt->bits[ix] = r;
-		    }
+		  diff |= dst_elt->bits[ix] ^ r;
+		  dst_elt->bits[ix] = r;
 		  ior |= r;
 		}
+	      changed = diff != 0;
 	    }
 	  else
 	    {
@@ -1139,6 +1410,7 @@ bitmap_and_compl_into (bitmap a, const_bitmap b)
   bitmap_element *next;
   BITMAP_WORD changed = 0;
 
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   if (a == b)
     {
       if (bitmap_empty_p (a))
@@ -1191,6 +1463,7 @@ bitmap_set_range (bitmap head, unsigned int start, unsigned int count)
   bitmap_element *elt, *elt_prev;
   unsigned int i;
 
+  gcc_checking_assert (!head->tree_form);
   if (!count)
     return;
 
@@ -1296,6 +1569,7 @@ bitmap_clear_range (bitmap head, unsigned int start, unsigned int count)
   unsigned int first_index, end_bit_plus1, last_index;
   bitmap_element *elt;
 
+  gcc_checking_assert (!head->tree_form);
   if (!count)
     return;
 
@@ -1431,6 +1705,7 @@ bitmap_compl_and_into (bitmap a, const_bitmap b)
   bitmap_element *a_prev = NULL;
   bitmap_element *next;
 
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   gcc_assert (a != b);
 
   if (bitmap_empty_p (a))
@@ -1509,15 +1784,16 @@ bitmap_elt_ior (bitmap dst, bitmap_element *dst_elt, bitmap_element *dst_prev,
 
       if (!changed && dst_elt && dst_elt->indx == a_elt->indx)
 	{
+	  BITMAP_WORD diff = 0;
+
+	  /* As in bitmap_and_compl, avoid a branch per word.  */
 	  for (ix = 0; ix < BITMAP_ELEMENT_WORDS; ix++)
 	    {
 	      BITMAP_WORD r = a_elt->bits[ix] | b_elt->bits[ix];
-	      if (r != dst_elt->bits[ix])
-		{
-		  dst_elt->bits[ix] = r;
-		  changed = true;
-		}
+	      diff |= dst_elt->bits[ix] ^ r;
+	      dst_elt->bits[ix] = r;
 	    }
+	  changed = diff != 0;
 	}
       else
 	{
@@ -1562,6 +1838,7 @@ bitmap_ior (bitmap dst, const_bitmap a, const_bitmap b)
   bitmap_element **dst_prev_pnext = &dst->first;
   bool changed = false;
 
+  gcc_checking_assert (!dst->tree_form && !a->tree_form && !b->tree_form);
   gcc_assert (dst != a && dst != b);
 
   while (a_elt || b_elt)
@@ -1610,6 +1887,7 @@ bitmap_ior_into (bitmap a, const_bitmap b)
   bitmap_element **a_prev_pnext = &a->first;
   bool changed = false;
 
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   if (a == b)
     return false;
 
@@ -1648,6 +1926,7 @@ bitmap_xor (bitmap dst, const_bitmap a, const_bitmap b)
   const bitmap_element *b_elt = b->first;
   bitmap_element *dst_prev = NULL;
 
+  gcc_checking_assert (!dst->tree_form && !a->tree_form && !b->tree_form);
   gcc_assert (dst != a && dst != b);
   if (a == b)
     {
@@ -1724,6 +2003,7 @@ bitmap_xor_into (bitmap a, const_bitmap b)
   const bitmap_element *b_elt = b->first;
   bitmap_element *a_prev = NULL;
 
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   if (a == b)
     {
       bitmap_clear (a);
@@ -1783,6 +2063,7 @@ bitmap_equal_p (const_bitmap a, const_bitmap b)
   const bitmap_element *b_elt;
   unsigned ix;
 
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   for (a_elt = a->first, b_elt = b->first;
        a_elt && b_elt;
        a_elt = a_elt->next, b_elt = b_elt->next)
@@ -1805,6 +2086,7 @@ bitmap_intersect_p (const_bitmap a, const_bitmap b)
   const bitmap_element *b_elt;
   unsigned ix;
 
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   for (a_elt = a->first, b_elt = b->first;
        a_elt && b_elt;)
     {
@@ -1832,6 +2114,8 @@ bitmap_intersect_compl_p (const_bitmap a, const_bitmap b)
   const bitmap_element *a_elt;
   const bitmap_element *b_elt;
   unsigned ix;
+
+  gcc_checking_assert (!a->tree_form && !b->tree_form);
   for (a_elt = a->first, b_elt = b->first;
        a_elt && b_elt;)
     {
@@ -1866,6 +2150,8 @@ bitmap_ior_and_compl (bitmap dst, const_bitmap a, const_bitmap b, const_bitmap k
   bitmap_element *dst_prev = NULL;
   bitmap_element **dst_prev_pnext = &dst->first;
 
+  gcc_checking_assert (!dst->tree_form && !a->tree_form
+		       && !b->tree_form && !kill->tree_form);
   gcc_assert (dst != a && dst != b && dst != kill);
 
   /* Special cases.  We don't bother checking for bitmap_equal_p (b, kill).  */
@@ -1988,6 +2274,7 @@ bitmap_ior_and_into (bitmap a, const_bitmap b, const_bitmap c)
   bool changed = false;
   unsigned ix;
 
+  gcc_checking_assert (!a->tree_form && !b->tree_form && !c->tree_form);
   if (b == c)
     return bitmap_ior_into (a, b);
   if (bitmap_empty_p (b) || bitmap_empty_p (c))
@@ -2061,6 +2348,7 @@ bitmap_hash (const_bitmap head)
   BITMAP_WORD hash = 0;
   int ix;
 
+  gcc_checking_assert (!head->tree_form);
   for (ptr = head->first; ptr; ptr = ptr->next)
     {
       hash ^= ptr->indx;
@@ -2076,13 +2364,22 @@ bitmap_hash (const_bitmap head)
 DEBUG_FUNCTION void
 debug_bitmap_file (FILE *file, const_bitmap head)
 {
-  const bitmap_element *ptr;
+  auto_vec<bitmap_element *, 32> elts;
+  bitmap_element *ptr;
+  unsigned int ix;
 
   fprintf (file, "\nfirst = " HOST_PTR_PRINTF
-	   " current = " HOST_PTR_PRINTF " indx = %u\n",
-	   (void *) head->first, (void *) head->current, head->indx);
+	   " current = " HOST_PTR_PRINTF " indx = %u%s\n",
+	   (void *) head->first, (void *) head->current, head->indx,
+	   head->tree_form ? " (tree view)" : "");
 
-  for (ptr = head->first; ptr; ptr = ptr->next)
+  if (head->tree_form)
+    bitmap_tree_to_vec (elts, head->first);
+  else
+    for (bitmap_element *elt = head->first; elt; elt = elt->next)
+      elts.safe_push (elt);
+
+  FOR_EACH_VEC_ELT (elts, ix, ptr)
     {
       unsigned int i, j, col = 26;
 
@@ -2131,11 +2428,32 @@ bitmap_print (FILE *file, const_bitmap head, const char *prefix,
   bitmap_iterator bi;
 
   fputs (prefix, file);
-  EXECUTE_IF_SET_IN_BITMAP (head, 0, i, bi)
-    {
-      fprintf (file, "%s%d", comma, i);
-      comma = ", ";
+  if (head->tree_form)
+    {
+      /* The iterators only walk lists, so visit the elements in order
+	 by hand.  */
+      auto_vec<bitmap_element *, 32> elts;
+      bitmap_element *ptr;
+      unsigned int ix, j, k;
+
+      bitmap_tree_to_vec (elts, head->first);
+      FOR_EACH_VEC_ELT (elts, ix, ptr)
+	for (j = 0; j < BITMAP_ELEMENT_WORDS; j++)
+	  for (k = 0; k < BITMAP_WORD_BITS; k++)
+	    if ((ptr->bits[j] >> k) & 1)
+	      {
+		fprintf (file, "%s%u", comma,
+			 (ptr->indx * BITMAP_ELEMENT_ALL_BITS
+			  + j * BITMAP_WORD_BITS + k));
+		comma = ", ";
+	      }
     }
+  else
+    EXECUTE_IF_SET_IN_BITMAP (head, 0, i, bi)
+      {
+	fprintf (file, "%s%d", comma, i);
+	comma = ", ";
+      }
   fputs (suffix, file);
 }
 
@@ -2262,6 +2580,50 @@ test_bitmap_single_bit_set_p ()
   ASSERT_EQ (1066, bitmap_first_set_bit (b));
 }
 
+/* Verify that a bitmap in tree view answers queries like one in list
+   view, and that switching views preserves its contents.  */
+
+static void
+test_tree_view ()
+{
+  bitmap_head tree, list;
+  bitmap_initialize (&tree, &bitmap_default_obstack);
+  bitmap_initialize (&list, &bitmap_default_obstack);
+  bitmap_tree_view (&tree);
+
+  /* Touch elements in a scattered order, so that the splay tree gets
+     reshaped repeatedly.  */
+  for (int i = 0; i < 1000; i++)
+    {
+      int bit = (i * 7919) % 100000;
+      ASSERT_EQ (bitmap_set_bit (&list, bit), bitmap_set_bit (&tree, bit));
+    }
+  for (int i = 0; i < 1000; i += 3)
+    {
+      int bit = (i * 7919) % 100000;
+      ASSERT_EQ (bitmap_clear_bit (&list, bit),
+		 bitmap_clear_bit (&tree, bit));
+    }
+  for (int bit = 0; bit < 100000; bit += 37)
+    ASSERT_EQ (bitmap_bit_p (&list, bit), bitmap_bit_p (&tree, bit));
+  ASSERT_FALSE (bitmap_clear_bit (&tree, 100001));
+
+  bitmap_list_view (&tree);
+  ASSERT_TRUE (bitmap_equal_p (&list, &tree));
+
+  /* Clearing keeps the view; the bitmap is then usable again.  */
+  bitmap_tree_view (&tree);
+  bitmap_clear (&tree);
+  ASSERT_TRUE (bitmap_empty_p (&tree));
+  ASSERT_TRUE (bitmap_set_bit (&tree, 5));
+  ASSERT_TRUE (bitmap_clear_bit (&tree, 5));
+  ASSERT_TRUE (bitmap_empty_p (&tree));
+  bitmap_list_view (&tree);
+
+  bitmap_clear (&tree);
+  bitmap_clear (&list);
+}
+
 /* Run all of the selftests within this file.  */
 
 void
@@ -2272,6 +2634,7 @@ bitmap_c_tests ()
   test_clear_bit_in_middle ();
   test_copying ();
   test_bitmap_single_bit_set_p ();
+  test_tree_view ();
 }
 
 } // namespace selftest
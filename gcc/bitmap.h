@@ -125,7 +125,23 @@ along with GCC; see the file COPYING3.  If not see
 
    A single free-list is used for all sets allocated in GGC space.  This is
    bad for persistent sets, so persistent sets should be allocated on an
-   obstack whenever possible.  */
+   obstack whenever possible.
+
+   For random-access sets with a large, unknown universe, a bitmap can
+   be switched to a "tree view" with bitmap_tree_view, in which the
+   elements are kept in a splay tree keyed on their index rather than
+   in a linked list.  This makes the following operations O(log E)
+   amortized, independent of the access pattern:
+
+     * member_p			: bitmap_bit_p
+     * add_member		: bitmap_set_bit
+     * remove_member		: bitmap_clear_bit
+
+   Only these operations, bitmap_clear, bitmap_empty_p and the debug
+   and print functions are supported on a bitmap in tree view; anything
+   else, including the iterators, requires switching back with
+   bitmap_list_view, which is O(E).  The tree view is not available
+   for GC-allocated bitmaps.  */
 
 #include "obstack.h"
 
@@ -232,11 +248,16 @@ struct GTY((chain_next ("%h.next"), chain_prev ("%h.prev"))) bitmap_element {
 };
 
 /* Head of bitmap linked list.  The 'current' member points to something
-   already pointed to by the chain started by first, so GTY((skip)) it.  */
+   already pointed to by the chain started by first, so GTY((skip)) it.
+
+   In tree view, FIRST is the root of a splay tree of the elements, with
+   the PREV and NEXT fields of each element pointing to its left and right
+   children, and CURRENT is the same as FIRST.  */
 
 struct GTY(()) bitmap_head {
   unsigned int indx;			/* Index of last element looked at.  */
-  unsigned int descriptor_id;		/* Unique identifier for the allocation
+  unsigned tree_form: 1;		/* Nonzero if in tree view.  */
+  unsigned descriptor_id: 31;		/* Unique identifier for the allocation
 					   site of this bitmap, for detailed
 					   statistics gathering.  */
   bitmap_element *first;		/* First element in linked list.  */
@@ -318,6 +339,10 @@ extern bool bitmap_set_bit (bitmap, int);
 /* Return true if a register is set in a register set.  */
 extern int bitmap_bit_p (bitmap, int);
 
+/* Switch a bitmap between the linked-list and splay-tree views.  */
+extern void bitmap_tree_view (bitmap);
+extern void bitmap_list_view (bitmap);
+
 /* Debug functions to print a bitmap linked list.  */
 extern void debug_bitmap (const_bitmap);
 extern void debug_bitmap_file (FILE *, const_bitmap);
@@ -338,6 +363,7 @@ static inline void
 bitmap_initialize_stat (bitmap head, bitmap_obstack *obstack MEM_STAT_DECL)
 {
   head->first = head->current = NULL;
+  head->tree_form = false;
   head->obstack = obstack;
   if (GATHER_STATISTICS)
     bitmap_register (head PASS_MEM_STAT);
@@ -401,6 +427,7 @@ static inline void
 bmp_iter_set_init (bitmap_iterator *bi, const_bitmap map,
 		   unsigned start_bit, unsigned *bit_no)
 {
+  gcc_checking_assert (!map->tree_form);
   bi->elt1 = map->first;
   bi->elt2 = NULL;
 
@@ -443,6 +470,7 @@ static inline void
 bmp_iter_and_init (bitmap_iterator *bi, const_bitmap map1, const_bitmap map2,
 		   unsigned start_bit, unsigned *bit_no)
 {
+  gcc_checking_assert (!map1->tree_form && !map2->tree_form);
   bi->elt1 = map1->first;
   bi->elt2 = map2->first;
 
@@ -512,6 +540,7 @@ bmp_iter_and_compl_init (bitmap_iterator *bi,
 			 const_bitmap map1, const_bitmap map2,
 			 unsigned start_bit, unsigned *bit_no)
 {
+  gcc_checking_assert (!map1->tree_form && !map2->tree_form);
   bi->elt1 = map1->first;
   bi->elt2 = map2->first;
 
@@ -34,6 +34,15 @@ along with GCC; see the file COPYING3.  If not see
 static int header_time, body_time;
 static splay_tree file_info_tree;
 
+/* For -ftime-trace, the headers currently being read, innermost last,
+   and the times at which we started reading them.  */
+struct header_trace
+{
+  const char *name;
+  uint64_t start;
+};
+static vec<header_trace> header_trace_stack;
+
 int pending_lang_change; /* If we need to switch languages - C++ only */
 int c_header_level;	 /* depth in C headers - C++ only */
 
@@ -204,6 +213,11 @@ fe_file_change (const line_map_ordinary *new_map)
 
 	  input_location = new_map->start_location;
 	  (*debug_hooks->start_source_file) (line, LINEMAP_FILE (new_map));
+	  if (time_trace_enabled)
+	    {
+	      header_trace h = { LINEMAP_FILE (new_map), time_trace_now () };
+	      header_trace_stack.safe_push (h);
+	    }
 #ifndef NO_IMPLICIT_EXTERN_C
 	  if (c_header_level)
 	    ++c_header_level;
@@ -228,6 +242,13 @@ fe_file_change (const line_map_ordinary *new_map)
       input_location = new_map->start_location;
 
       (*debug_hooks->end_source_file) (LINEMAP_LINE (new_map));
+      if (!header_trace_stack.is_empty ())
+	{
+	  header_trace h = header_trace_stack.pop ();
+	  uint64_t now = time_trace_now ();
+	  if (time_trace_wanted_p (h.start, now))
+	    time_trace_add ("Source", h.name, h.start, now);
+	}
     }
 
   update_header_times (LINEMAP_FILE (new_map));
@@ -197,7 +197,7 @@ static inline void
 connect_src (edge e)
 {
   vec_safe_push (e->src->succs, e);
-  df_mark_solutions_dirty ();
+  df_mark_edge_solutions_dirty (e);
 }
 
 /* Connect E to E->dest.  */
@@ -208,7 +208,7 @@ connect_dest (edge e)
   basic_block dest = e->dest;
   vec_safe_push (dest->preds, e);
   e->dest_idx = EDGE_COUNT (dest->preds) - 1;
-  df_mark_solutions_dirty ();
+  df_mark_edge_solutions_dirty (e);
 }
 
 /* Disconnect edge E from E->src.  */
@@ -225,7 +225,7 @@ disconnect_src (edge e)
       if (tmp == e)
 	{
 	  src->succs->unordered_remove (ei.index);
-	  df_mark_solutions_dirty ();
+	  df_mark_edge_solutions_dirty (e);
 	  return;
 	}
       else
@@ -249,7 +249,7 @@ disconnect_dest (edge e)
      to update dest_idx of the edge that moved into the "hole".  */
   if (dest_idx < EDGE_COUNT (dest->preds))
     EDGE_PRED (dest, dest_idx)->dest_idx = dest_idx;
-  df_mark_solutions_dirty ();
+  df_mark_edge_solutions_dirty (e);
 }
 
 /* Create an edge connecting SRC and DEST with flags FLAGS.  Return newly
@@ -32,6 +32,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "tree-inline.h"
 #include "ubsan.h"
 #include "gimple-fold.h"
+#include "timevar.h"
 
 static bool verify_constant (tree, bool, bool *, bool *);
 #define VERIFY_CONSTANT(X)						\
@@ -3951,10 +3952,15 @@ cxx_eval_constant_expression (const constexpr_ctx *ctx, tree t,
 	  r = build_constructor (TREE_TYPE (t), NULL);
 	  TREE_CONSTANT (r) = true;
 	}
+      /* Don't copy the initializer here: usually we only want one element
+	 of it, and copying a large array for each element we read makes
+	 the evaluation quadratic.  The evaluator never modifies a value it
+	 has not unshared itself, and the outermost caller unshares the
+	 result.  */
       else if (ctx->strict)
-	r = decl_really_constant_value (t);
+	r = decl_really_constant_value (t, /*unshare_p=*/false);
       else
-	r = decl_constant_value (t);
+	r = decl_constant_value (t, /*unshare_p=*/false);
       if (TREE_CODE (r) == TARGET_EXPR
 	  && TREE_CODE (TARGET_EXPR_INITIAL (r)) == CONSTRUCTOR)
 	r = TARGET_EXPR_INITIAL (r);
@@ -4634,8 +4640,23 @@ cxx_eval_outermost_constant_expr (tree t, bool allow_non_constant,
 	r = TARGET_EXPR_INITIAL (r);
     }
 
+  time_trace_span span ("ConstantEvaluation");
   r = cxx_eval_constant_expression (&ctx, r,
 				    false, &non_constant_p, &overflow_p);
+  if (span.wanted_p ())
+    {
+      expanded_location xloc
+	= expand_location (EXPR_LOC_OR_LOC (t, input_location));
+      if (xloc.file)
+	{
+	  char *where = xasprintf ("%s:%d:%d", xloc.file, xloc.line,
+				   xloc.column);
+	  span.finish (where);
+	  free (where);
+	}
+      else
+	span.finish (NULL);
+    }
 
   verify_constant (r, allow_non_constant, &non_constant_p, &overflow_p);
 
@@ -4678,10 +4699,12 @@ cxx_eval_outermost_constant_expr (tree t, bool allow_non_constant,
   if (!non_constant_p && overflow_p)
     non_constant_p = true;
 
-  /* Unshare the result unless it's a CONSTRUCTOR in which case it's already
-     unshared.  */
+  /* Unshare the result.  Even a CONSTRUCTOR might be (part of) the
+     initializer of a variable; see the VAR_DECL case of
+     cxx_eval_constant_expression.  */
   bool should_unshare = true;
-  if (r == t || TREE_CODE (r) == CONSTRUCTOR)
+  if (r == t || (TREE_CODE (t) == TARGET_EXPR
+		 && TARGET_EXPR_INITIAL (t) == r))
     should_unshare = false;
 
   if (non_constant_p && !allow_non_constant)
@@ -333,6 +333,7 @@ struct GTY(()) lang_identifier {
   tree class_template_info;
   tree label_value;
   bool oracle_looked_up;
+  bool namespace_bindings_hashed;
 };
 
 /* Return a typed pointer version of T if it designates a
@@ -599,6 +600,10 @@ enum GTY(()) abstract_class_use {
   (LANG_IDENTIFIER_CAST (NODE)->namespace_bindings)
 #define IDENTIFIER_TEMPLATE(NODE)	\
   (LANG_IDENTIFIER_CAST (NODE)->class_template_info)
+/* True if the IDENTIFIER_NAMESPACE_BINDINGS of NODE have been entered
+   into a hash table keyed by scope; see name-lookup.c.  */
+#define IDENTIFIER_NAMESPACE_BINDINGS_HASHED(NODE)	\
+  (LANG_IDENTIFIER_CAST (NODE)->namespace_bindings_hashed)
 
 /* The IDENTIFIER_BINDING is the innermost cxx_binding for the
     identifier.  It's PREVIOUS is the next outermost binding.  Each
@@ -6067,6 +6072,8 @@ extern tree create_temporary_var		(tree);
 extern void initialize_vtbl_ptrs		(tree);
 extern tree scalar_constant_value		(tree);
 extern tree decl_really_constant_value		(tree);
+extern tree decl_really_constant_value		(tree, bool);
+extern tree decl_constant_value			(tree, bool);
 extern int diagnose_uninitialized_cst_or_ref_member (tree, bool, bool);
 extern tree build_vtbl_address                  (tree);
 extern bool maybe_reject_flexarray_init		(tree, tree);
@@ -2167,16 +2167,95 @@ make_lambda_name (void)
   return get_identifier (buf);
 }
 
-/* Return (from the stack of) the BINDING, if any, established at SCOPE.  */
+/* The namespace bindings of a name that is declared in many namespaces
+   are also entered into a hash table keyed by scope and name, so that
+   finding the binding for one namespace doesn't have to walk the
+   IDENTIFIER_NAMESPACE_BINDINGS of all the others.  A name is entered
+   into the table once a lookup has walked NAMESPACE_BINDINGS_HASH_THRESHOLD
+   of its bindings; see IDENTIFIER_NAMESPACE_BINDINGS_HASHED.  */
 
-static inline cxx_binding *
-find_binding (cp_binding_level *scope, cxx_binding *binding)
+#define NAMESPACE_BINDINGS_HASH_THRESHOLD 8
+
+struct GTY((for_user)) scoped_binding {
+  cp_binding_level *scope;
+  tree name;
+  cxx_binding *binding;
+};
+
+struct scoped_binding_hasher : ggc_ptr_hash<scoped_binding>
+{
+  static hashval_t hash (scoped_binding *);
+  static bool equal (scoped_binding *, scoped_binding *);
+};
+
+static GTY(()) hash_table<scoped_binding_hasher> *scoped_bindings;
+
+/* Statistics for namespace binding lookups, printed by
+   print_name_lookup_statistics.  */
+
+static int n_namespace_binding_lookups;
+static int n_namespace_bindings_searched;
+static int n_hashed_namespace_binding_lookups;
+static int n_names_hashed;
+
+/* Return a hash for the binding of NAME in SCOPE.  Use the UID of the
+   namespace rather than the address of SCOPE, so that the hash is still
+   valid after PCH restore.  */
+
+static inline hashval_t
+scoped_binding_hash (cp_binding_level *scope, tree name)
+{
+  hashval_t h = IDENTIFIER_HASH_VALUE (name);
+  if (scope->this_entity)
+    h = iterative_hash_hashval_t (DECL_UID (scope->this_entity), h);
+  return h;
+}
+
+hashval_t
+scoped_binding_hasher::hash (scoped_binding *e)
 {
-  for (; binding != NULL; binding = binding->previous)
-    if (binding->scope == scope)
-      return binding;
+  return scoped_binding_hash (e->scope, e->name);
+}
 
-  return (cxx_binding *)0;
+bool
+scoped_binding_hasher::equal (scoped_binding *e1, scoped_binding *e2)
+{
+  return e1->scope == e2->scope && e1->name == e2->name;
+}
+
+/* Enter BINDING, the binding of NAME in its scope, into
+   scoped_bindings.  */
+
+static void
+hash_namespace_binding (tree name, cxx_binding *binding)
+{
+  scoped_binding elt = { binding->scope, name, binding };
+  scoped_binding **slot
+    = scoped_bindings->find_slot_with_hash (&elt,
+					    scoped_binding_hash (elt.scope,
+								 name),
+					    INSERT);
+  gcc_checking_assert (*slot == NULL);
+  *slot = ggc_alloc<scoped_binding> ();
+  **slot = elt;
+}
+
+/* Enter all the namespace bindings of NAME into scoped_bindings, and
+   mark NAME so that its future bindings are entered there too.  */
+
+static void
+hash_namespace_bindings (tree name)
+{
+  if (scoped_bindings == NULL)
+    scoped_bindings = hash_table<scoped_binding_hasher>::create_ggc (127);
+
+  for (cxx_binding *b = IDENTIFIER_NAMESPACE_BINDINGS (name);
+       b; b = b->previous)
+    hash_namespace_binding (name, b);
+  IDENTIFIER_NAMESPACE_BINDINGS_HASHED (name) = true;
+
+  if (GATHER_STATISTICS)
+    n_names_hashed++;
 }
 
 /* Return the binding for NAME in SCOPE, if any.  Otherwise, return NULL.  */
@@ -2187,10 +2266,37 @@ cp_binding_level_find_binding_for_name (cp_binding_level *scope, tree name)
   cxx_binding *b = IDENTIFIER_NAMESPACE_BINDINGS (name);
   if (b)
     {
+      if (GATHER_STATISTICS)
+	n_namespace_binding_lookups++;
+
       /* Fold-in case where NAME is used only once.  */
       if (scope == b->scope && b->previous == NULL)
 	return b;
-      return find_binding (scope, b);
+
+      if (!IDENTIFIER_NAMESPACE_BINDINGS_HASHED (name))
+	{
+	  int n = 0;
+	  for (; b != NULL; b = b->previous)
+	    {
+	      if (GATHER_STATISTICS)
+		n_namespace_bindings_searched++;
+	      if (b->scope == scope)
+		return b;
+	      if (++n == NAMESPACE_BINDINGS_HASH_THRESHOLD)
+		break;
+	    }
+	  if (b == NULL)
+	    return NULL;
+	  hash_namespace_bindings (name);
+	}
+
+      if (GATHER_STATISTICS)
+	n_hashed_namespace_binding_lookups++;
+      scoped_binding elt = { scope, name, NULL };
+      scoped_binding *e
+	= scoped_bindings->find_with_hash (&elt,
+					   scoped_binding_hash (scope, name));
+      return e ? e->binding : NULL;
     }
   return NULL;
 }
@@ -2213,9 +2319,25 @@ binding_for_name (cp_binding_level *scope, tree name)
   result->is_local = false;
   result->value_is_inherited = false;
   IDENTIFIER_NAMESPACE_BINDINGS (name) = result;
+  if (IDENTIFIER_NAMESPACE_BINDINGS_HASHED (name))
+    hash_namespace_binding (name, result);
   return result;
 }
 
+/* Print statistics about namespace binding lookups.  */
+
+void
+print_name_lookup_statistics (void)
+{
+  if (! GATHER_STATISTICS)
+    return;
+
+  fprintf (stderr, "%d namespace bindings searched in %d lookups\n",
+	   n_namespace_bindings_searched, n_namespace_binding_lookups);
+  fprintf (stderr, "%d hashed namespace binding lookups for %d names\n",
+	   n_hashed_namespace_binding_lookups, n_names_hashed);
+}
+
 /* Walk through the bindings associated to the name of FUNCTION,
    and return the first declaration of a function with a
    "C" linkage specification, a.k.a 'extern "C"'.
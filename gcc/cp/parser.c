@@ -625,9 +625,6 @@ cp_lexer_alloc (void)
 
   lexer->saved_tokens.create (CP_SAVED_TOKEN_STACK);
 
-  /* Create the buffer.  */
-  vec_alloc (lexer->buffer, CP_LEXER_BUFFER_SIZE);
-
   return lexer;
 }
 
@@ -648,16 +645,32 @@ cp_lexer_new_main (void)
 
   lexer = cp_lexer_alloc ();
 
+  /* Collect the tokens in a heap vector first and copy them into the
+     GC buffer only once we know how many there are.  Growing the GC
+     vector in place would leave every superseded copy of the buffer
+     on the collector's free list until the next collection, so the
+     peak memory use would be several times the size of the final
+     buffer.  There is no collection while we are lexing, so the trees
+     referenced from the heap vector cannot go away underneath us.  */
+  vec<cp_token> tokens;
+  tokens.create (CP_LEXER_BUFFER_SIZE);
+
   /* Put the first token in the buffer.  */
-  lexer->buffer->quick_push (token);
+  tokens.quick_push (token);
 
   /* Get the remaining tokens from the preprocessor.  */
   while (token.type != CPP_EOF)
     {
       cp_lexer_get_preprocessor_token (lexer, &token);
-      vec_safe_push (lexer->buffer, token);
+      tokens.safe_push (token);
     }
 
+  vec_safe_reserve_exact (lexer->buffer, tokens.length ());
+  lexer->buffer->quick_grow (tokens.length ());
+  memcpy (lexer->buffer->address (), tokens.address (),
+	  tokens.length () * sizeof (cp_token));
+  tokens.release ();
+
   lexer->last_token = lexer->buffer->address ()
                       + lexer->buffer->length ()
 		      - 1;
@@ -27072,7 +27085,14 @@ cp_parser_enclosed_template_argument_list (cp_parser* parser)
 
 /* MEMBER_FUNCTION is a member function, or a friend.  If default
    arguments, or the body of the function have not yet been parsed,
-   parse them now.  */
+   parse them now.
+
+   We parse the body as soon as the outermost enclosing class is
+   complete rather than waiting until the function is odr-used: names
+   in the body must be looked up in the context of the class
+   definition, so declarations that follow the class must not be
+   visible, and ill-formed bodies must be diagnosed even if the
+   function is never used.  */
 
 static void
 cp_parser_late_parsing_for_member (cp_parser* parser, tree member_function)
@@ -96,6 +96,10 @@ struct GTY((for_user)) spec_entry
   tree tmpl;
   tree args;
   tree spec;
+  /* The hash of TMPL and ARGS, as computed by hash_tmpl_and_args.  It
+     is stored so that growing the table and rejecting mismatches on
+     lookup do not need to walk ARGS again.  */
+  hashval_t hash;
 };
 
 struct spec_hasher : ggc_ptr_hash<spec_entry>
@@ -148,6 +152,7 @@ static tree coerce_innermost_template_parms (tree, tree, tree, tsubst_flags_t,
 static void tsubst_enum	(tree, tree, tree);
 static tree add_to_template_args (tree, tree);
 static tree add_outermost_template_args (tree, tree);
+static hashval_t hash_tmpl_and_args (tree, tree);
 static bool check_instantiated_args (tree, tree, tsubst_flags_t);
 static int maybe_adjust_types_for_deduction (unification_kind_t, tree*, tree*,
 					     tree);
@@ -1046,11 +1051,13 @@ maybe_process_partial_specialization (tree type)
 		  elt.tmpl = most_general_template (tmpl);
 		  elt.args = CLASSTYPE_TI_ARGS (inst);
 		  elt.spec = inst;
+		  elt.hash = hash_tmpl_and_args (elt.tmpl, elt.args);
 
 		  type_specializations->remove_elt (&elt);
 
 		  elt.tmpl = tmpl;
 		  elt.args = INNERMOST_TEMPLATE_ARGS (elt.args);
+		  elt.hash = hash_tmpl_and_args (elt.tmpl, elt.args);
 
 		  spec_entry **slot
 		    = type_specializations->find_slot (&elt, INSERT);
@@ -1238,7 +1245,8 @@ retrieve_specialization (tree tmpl, tree args, hashval_t hash)
 	specializations = decl_specializations;
 
       if (hash == 0)
-	hash = spec_hasher::hash (&elt);
+	hash = hash_tmpl_and_args (tmpl, args);
+      elt.hash = hash;
       found = specializations->find_with_hash (&elt, hash);
       if (found)
 	return found->spec;
@@ -1517,7 +1525,8 @@ register_specialization (tree spec, tree tmpl, tree args, bool is_friend,
       elt.spec = spec;
 
       if (hash == 0)
-	hash = spec_hasher::hash (&elt);
+	hash = hash_tmpl_and_args (tmpl, args);
+      elt.hash = hash;
 
       slot =
 	decl_specializations->find_slot_with_hash (&elt, hash, INSERT);
@@ -1655,6 +1664,11 @@ spec_hasher::equal (spec_entry *e1, spec_entry *e2)
 {
   int equal;
 
+  /* Entries with different hashes cannot be equal; this avoids the
+     comparison of the arguments for most collisions.  */
+  if (e1->hash != e2->hash)
+    return false;
+
   ++comparing_specializations;
   equal = (e1->tmpl == e2->tmpl
 	   && comp_template_args (e1->args, e2->args));
@@ -1684,13 +1698,14 @@ hash_tmpl_and_args (tree tmpl, tree args)
   return iterative_hash_template_arg (args, val);
 }
 
-/* Returns a hash for a spec_entry node based on the TMPL and ARGS members,
-   ignoring SPEC.  */
+/* Returns the hash of a spec_entry node, which is based on the TMPL and
+   ARGS members, ignoring SPEC, and was computed when the entry was
+   built.  */
 
 hashval_t
 spec_hasher::hash (spec_entry *e)
 {
-  return hash_tmpl_and_args (e->tmpl, e->args);
+  return e->hash;
 }
 
 /* Recursively calculate a hash value for a template argument ARG, for use
@@ -1878,6 +1893,7 @@ reregister_specialization (tree spec, tree tinfo, tree new_spec)
   elt.tmpl = most_general_template (TI_TEMPLATE (tinfo));
   elt.args = TI_ARGS (tinfo);
   elt.spec = NULL_TREE;
+  elt.hash = hash_tmpl_and_args (elt.tmpl, elt.args);
 
   entry = decl_specializations->find (&elt);
   if (entry != NULL)
@@ -8692,7 +8708,8 @@ lookup_template_class_1 (tree d1, tree arglist, tree in_decl, tree context,
       elt.tmpl = gen_tmpl;
       elt.args = arglist;
       elt.spec = NULL_TREE;
-      hash = spec_hasher::hash (&elt);
+      hash = hash_tmpl_and_args (gen_tmpl, arglist);
+      elt.hash = hash;
       entry = type_specializations->find_with_hash (&elt, hash);
 
       if (entry)
@@ -9779,6 +9796,7 @@ tsubst_friend_function (tree decl, tree args)
 		      elt.tmpl = old_decl;
 		      elt.args = DECL_TI_ARGS (spec);
 		      elt.spec = NULL_TREE;
+		      elt.hash = hash_tmpl_and_args (elt.tmpl, elt.args);
 
 		      decl_specializations->remove_elt (&elt);
 
@@ -10795,7 +10813,10 @@ instantiate_class_template (tree type)
 {
   tree ret;
   timevar_push (TV_TEMPLATE_INST);
+  time_trace_span span ("InstantiateClass");
   ret = instantiate_class_template_1 (type);
+  if (span.wanted_p ())
+    span.finish (type_as_string (type, TFF_CLASS_KEY_OR_ENUM));
   timevar_pop (TV_TEMPLATE_INST);
   return ret;
 }
@@ -22567,6 +22588,8 @@ instantiate_decl (tree d, bool defer_ok, bool expl_inst_class_mem_p)
     return d;
 
   timevar_push (TV_TEMPLATE_INST);
+  time_trace_span span (VAR_P (d) ? "InstantiateVariable"
+			: "InstantiateFunction");
 
   /* Set TD to the template whose DECL_TEMPLATE_RESULT is the pattern
      for the instantiation.  */
@@ -22939,6 +22962,8 @@ instantiate_decl (tree d, bool defer_ok, bool expl_inst_class_mem_p)
 
 out:
   pop_deferring_access_checks ();
+  if (span.wanted_p ())
+    span.finish (decl_as_string (d, TFF_PLAIN_IDENTIFIER));
   timevar_pop (TV_TEMPLATE_INST);
   pop_tinst_level ();
   input_location = saved_loc;
@@ -22976,6 +23001,8 @@ instantiate_pending_templates (int retries)
       return;
     }
 
+  bool subtime = timevar_cond_start (TV_TEMPLATE_INST_PENDING);
+
   do
     {
       struct pending_template **t = &pending_templates;
@@ -23001,7 +23028,10 @@ instantiate_pending_templates (int retries)
 			instantiate_decl (fn,
 					  /*defer_ok=*/false,
 					  /*expl_inst_class_mem_p=*/false);
-		  if (COMPLETE_TYPE_P (instantiation))
+		  /* Completing the class can only help the entries we
+		     have already given up on during this pass; later
+		     entries will see it anyway.  */
+		  if (COMPLETE_TYPE_P (instantiation) && last)
 		    reconsider = 1;
 		}
 
@@ -23016,7 +23046,7 @@ instantiate_pending_templates (int retries)
 		    = instantiate_decl (instantiation,
 					/*defer_ok=*/false,
 					/*expl_inst_class_mem_p=*/false);
-		  if (DECL_TEMPLATE_INSTANTIATED (instantiation))
+		  if (DECL_TEMPLATE_INSTANTIATED (instantiation) && last)
 		    reconsider = 1;
 		}
 
@@ -23041,6 +23071,7 @@ instantiate_pending_templates (int retries)
   while (reconsider);
 
   input_location = saved_loc;
+  timevar_cond_stop (TV_TEMPLATE_INST_PENDING, subtime);
 }
 
 /* Substitute ARGVEC into T, which is a list of initializers for
@@ -63,7 +63,12 @@ some instruction within the block has changed.
 The top layer is the dataflow solution itself.  The dataflow solution
 is computed by using an efficient iterative solver and the transfer
 functions.  The dataflow solution must be recomputed whenever the
-control changes or if one of the transfer function changes.
+control changes or if one of the transfer function changes.  For
+problems marked incremental_p, such as LR, df_set_bb_dirty and the
+edge manipulation routines record which blocks changed, and only the
+blocks whose solution can depend on those are solved again; a call to
+df_mark_solutions_dirty, which does not say what changed, forces a
+solution from scratch.
 
 
 USAGE:
@@ -611,6 +616,7 @@ df_remove_problem (struct dataflow *dflow)
 	break;
       }
 
+  BITMAP_FREE (dflow->changed_blocks);
   (problem->remove_problem_fun) ();
   df->problems_by_index[problem->id] = NULL;
 }
@@ -815,6 +821,7 @@ rest_of_handle_df_finish (void)
   for (i = 0; i < df->num_problems_defined; i++)
     {
       struct dataflow *dflow = df->problems_in_order[i];
+      BITMAP_FREE (dflow->changed_blocks);
       dflow->problem->free_fun ();
     }
 
@@ -1108,17 +1115,25 @@ df_worklist_dataflow (struct dataflow *dataflow,
       bitmap_set_bit (considered, index);
     }
 
+  /* When solving incrementally only the blocks in BLOCKS_TO_SOLVE are
+     visited; the others keep their solution and are only used as
+     sources in the confluence functions.  */
+  bitmap blocks_to_solve = (dataflow->blocks_to_solve
+			    ? dataflow->blocks_to_solve : blocks_to_consider);
+
   /* Initialize the mapping of block index to postorder.  */
   for (i = 0; i < n_blocks; i++)
     {
       bbindex_to_postorder[blocks_in_postorder[i]] = i;
-      /* Add all blocks to the worklist.  */
-      bitmap_set_bit (pending, i);
+      /* Add the blocks to solve to the worklist.  */
+      if (blocks_to_solve == blocks_to_consider
+	  || bitmap_bit_p (blocks_to_solve, blocks_in_postorder[i]))
+	bitmap_set_bit (pending, i);
     }
 
   /* Initialize the problem. */
   if (dataflow->problem->init_fun)
-    dataflow->problem->init_fun (blocks_to_consider);
+    dataflow->problem->init_fun (blocks_to_solve);
 
   /* Solve it.  */
   df_worklist_dataflow_doublequeue (dataflow, pending, considered,
@@ -1146,6 +1161,48 @@ df_prune_to_subcfg (int list[], unsigned len, bitmap blocks)
 }
 
 
+/* Return the blocks in BLOCKS_TO_CONSIDER whose DFLOW solution can
+   depend on the transfer functions or edges of the blocks in
+   DFLOW->changed_blocks: the blocks from which a changed block can be
+   reached for a backward problem, and those that can be reached from
+   one for a forward problem.  */
+
+static bitmap
+df_blocks_to_resolve (struct dataflow *dflow, bitmap blocks_to_consider)
+{
+  bitmap blocks = BITMAP_ALLOC (&df_bitmap_obstack);
+  auto_vec<basic_block, 32> worklist;
+  bitmap_iterator bi;
+  unsigned int index;
+
+  EXECUTE_IF_AND_IN_BITMAP (dflow->changed_blocks, blocks_to_consider,
+			    0, index, bi)
+    {
+      bitmap_set_bit (blocks, index);
+      worklist.safe_push (BASIC_BLOCK_FOR_FN (cfun, index));
+    }
+
+  while (!worklist.is_empty ())
+    {
+      basic_block bb = worklist.pop ();
+      basic_block other;
+      edge e;
+      edge_iterator ei;
+
+      FOR_EACH_EDGE (e, ei, (dflow->problem->dir == DF_BACKWARD
+			     ? bb->preds : bb->succs))
+	{
+	  other = dflow->problem->dir == DF_BACKWARD ? e->src : e->dest;
+	  if (bitmap_bit_p (blocks_to_consider, other->index)
+	      && bitmap_set_bit (blocks, other->index))
+	    worklist.safe_push (other);
+	}
+    }
+
+  return blocks;
+}
+
+
 /* Execute dataflow analysis on a single dataflow problem.
 
    BLOCKS_TO_CONSIDER are the blocks whose solution can either be
@@ -1173,15 +1230,36 @@ df_analyze_problem (struct dataflow *dflow,
   if (dflow->problem->local_compute_fun)
     dflow->problem->local_compute_fun (blocks_to_consider);
 
+  /* If there is a solution for the whole function that only some
+     blocks have invalidated, recompute it just where it can have
+     changed.  The local compute function may have dropped
+     CHANGED_BLOCKS if some global input to the problem changed.  */
+  if (dflow->changed_blocks && !df->analyze_subset)
+    dflow->blocks_to_solve = df_blocks_to_resolve (dflow,
+						   blocks_to_consider);
+
   /* Solve the equations.  */
   if (dflow->problem->dataflow_fun)
     dflow->problem->dataflow_fun (dflow, blocks_to_consider,
 				  postorder, n_blocks);
+  BITMAP_FREE (dflow->blocks_to_solve);
 
   /* Massage the solution.  */
   if (dflow->problem->finalize_fun)
     dflow->problem->finalize_fun (blocks_to_consider);
 
+  /* Start tracking changes against the new solution.  A solution for
+     a subset of the blocks cannot be updated incrementally.  */
+  if (dflow->problem->incremental_p)
+    {
+      if (df->analyze_subset)
+	BITMAP_FREE (dflow->changed_blocks);
+      else if (dflow->changed_blocks)
+	bitmap_clear (dflow->changed_blocks);
+      else
+	dflow->changed_blocks = BITMAP_ALLOC (&df_bitmap_obstack);
+    }
+
 #ifdef ENABLE_DF_CHECKING
   if (dflow->problem->verify_end_fun)
     dflow->problem->verify_end_fun ();
@@ -1563,7 +1641,8 @@ df_clear_bb_info (struct dataflow *dflow, unsigned int index)
 }
 
 
-/* Mark the solutions as being out of date.  */
+/* Mark the solutions as being out of date.  Since it is not known
+   what changed, the solutions have to be recomputed from scratch.  */
 
 void
 df_mark_solutions_dirty (void)
@@ -1572,7 +1651,42 @@ df_mark_solutions_dirty (void)
     {
       int p;
       for (p = 1; p < df->num_problems_defined; p++)
-	df->problems_in_order[p]->solutions_dirty = true;
+	{
+	  struct dataflow *dflow = df->problems_in_order[p];
+	  dflow->solutions_dirty = true;
+	  BITMAP_FREE (dflow->changed_blocks);
+	}
+    }
+}
+
+
+/* Mark the solutions as being out of date because the transfer
+   function or the edges of BB have changed.  */
+
+static void
+df_mark_bb_solutions_dirty (basic_block bb)
+{
+  int p;
+  for (p = 1; p < df->num_problems_defined; p++)
+    {
+      struct dataflow *dflow = df->problems_in_order[p];
+      dflow->solutions_dirty = true;
+      if (dflow->changed_blocks)
+	bitmap_set_bit (dflow->changed_blocks, bb->index);
+    }
+}
+
+
+/* Mark the solutions as being out of date because edge E has been
+   added, removed or redirected.  */
+
+void
+df_mark_edge_solutions_dirty (edge e)
+{
+  if (df)
+    {
+      df_mark_bb_solutions_dirty (e->src);
+      df_mark_bb_solutions_dirty (e->dest);
     }
 }
 
@@ -1604,7 +1718,7 @@ df_set_bb_dirty (basic_block bb)
 	  if (dflow->out_of_date_transfer_functions)
 	    bitmap_set_bit (dflow->out_of_date_transfer_functions, bb->index);
 	}
-      df_mark_solutions_dirty ();
+      df_mark_bb_solutions_dirty (bb);
     }
 }
 
@@ -1644,6 +1758,8 @@ df_clear_bb_dirty (basic_block bb)
       struct dataflow *dflow = df->problems_in_order[p];
       if (dflow->out_of_date_transfer_functions)
 	bitmap_clear_bit (dflow->out_of_date_transfer_functions, bb->index);
+      if (dflow->changed_blocks)
+	bitmap_clear_bit (dflow->changed_blocks, bb->index);
     }
 }
 
@@ -1683,6 +1799,25 @@ df_compact_blocks (void)
 	    }
 	}
 
+      /* Likewise for the blocks changed since the last solution.  */
+      if (dflow->changed_blocks)
+	{
+	  bitmap_copy (&tmp, dflow->changed_blocks);
+	  bitmap_clear (dflow->changed_blocks);
+	  if (bitmap_bit_p (&tmp, ENTRY_BLOCK))
+	    bitmap_set_bit (dflow->changed_blocks, ENTRY_BLOCK);
+	  if (bitmap_bit_p (&tmp, EXIT_BLOCK))
+	    bitmap_set_bit (dflow->changed_blocks, EXIT_BLOCK);
+
+	  i = NUM_FIXED_BLOCKS;
+	  FOR_EACH_BB_FN (bb, cfun)
+	    {
+	      if (bitmap_bit_p (&tmp, bb->index))
+		bitmap_set_bit (dflow->changed_blocks, i);
+	      i++;
+	    }
+	}
+
       /* Now shuffle the block info for the problem.  */
       if (dflow->problem->free_bb_fun)
 	{
@@ -1812,8 +1947,10 @@ df_bb_delete (int bb_index)
 	    }
 	}
     }
+  /* The neighbors of BB are marked as their edges to BB are
+     removed.  */
+  df_mark_bb_solutions_dirty (bb);
   df_clear_bb_dirty (bb);
-  df_mark_solutions_dirty ();
 }
 
 
@@ -695,7 +695,8 @@ static const struct df_problem problem_RD =
   NULL,                       /* Dependent problem.  */
   sizeof (struct df_rd_bb_info),/* Size of entry of block_info array.  */
   TV_DF_RD,                   /* Timing variable.  */
-  true                        /* Reset blocks on dropping out of blocks_to_analyze.  */
+  true,                       /* Reset blocks on dropping out of blocks_to_analyze.  */
+  false                       /* Solved incrementally.  */
 };
 
 
@@ -891,7 +892,10 @@ df_lr_local_compute (bitmap all_blocks ATTRIBUTE_UNUSED)
 {
   unsigned int bb_index, i;
   bitmap_iterator bi;
+  bitmap_head old_hardware_regs_used;
 
+  bitmap_initialize (&old_hardware_regs_used, &df_bitmap_obstack);
+  bitmap_copy (&old_hardware_regs_used, &df->hardware_regs_used);
   bitmap_clear (&df->hardware_regs_used);
 
   /* The all-important stack pointer must always be live.  */
@@ -925,6 +929,12 @@ df_lr_local_compute (bitmap all_blocks ATTRIBUTE_UNUSED)
 	bitmap_set_bit (&df->hardware_regs_used, pic_offset_table_regnum);
     }
 
+  /* These registers are live everywhere, so if they changed (for example
+     when reload completed) the solution cannot be updated incrementally.  */
+  if (!bitmap_equal_p (&old_hardware_regs_used, &df->hardware_regs_used))
+    BITMAP_FREE (df_lr->changed_blocks);
+  bitmap_clear (&old_hardware_regs_used);
+
   EXECUTE_IF_SET_IN_BITMAP (df_lr->out_of_date_transfer_functions, 0, bb_index, bi)
     {
       if (bb_index == EXIT_BLOCK)
@@ -1131,6 +1141,10 @@ df_lr_verify_solution_start (void)
   /* Set it true so that the solution is recomputed.  */
   df_lr->solutions_dirty = true;
 
+  /* Recompute it from scratch rather than incrementally, so that the
+     check also covers the incremental update of the solution.  */
+  BITMAP_FREE (df_lr->changed_blocks);
+
   problem_data = (struct df_lr_problem_data *)df_lr->problem_data;
   problem_data->in = XNEWVEC (bitmap_head, last_basic_block_for_fn (cfun));
   problem_data->out = XNEWVEC (bitmap_head, last_basic_block_for_fn (cfun));
@@ -1217,7 +1231,8 @@ static const struct df_problem problem_LR =
   NULL,                       /* Dependent problem.  */
   sizeof (struct df_lr_bb_info),/* Size of entry of block_info array.  */
   TV_DF_LR,                   /* Timing variable.  */
-  false                       /* Reset blocks on dropping out of blocks_to_analyze.  */
+  false,                      /* Reset blocks on dropping out of blocks_to_analyze.  */
+  true                        /* Solved incrementally.  */
 };
 
 
@@ -1745,7 +1760,8 @@ static const struct df_problem problem_LIVE =
   &problem_LR,                  /* Dependent problem.  */
   sizeof (struct df_live_bb_info),/* Size of entry of block_info array.  */
   TV_DF_LIVE,                   /* Timing variable.  */
-  false                         /* Reset blocks on dropping out of blocks_to_analyze.  */
+  false,                        /* Reset blocks on dropping out of blocks_to_analyze.  */
+  false                         /* Solved incrementally.  */
 };
 
 
@@ -2196,7 +2212,8 @@ static const struct df_problem problem_MIR =
   NULL,                         /* Dependent problem.  */
   sizeof (struct df_mir_bb_info),/* Size of entry of block_info array.  */
   TV_DF_MIR,                    /* Timing variable.  */
-  false                         /* Reset blocks on dropping out of blocks_to_analyze.  */
+  false,                        /* Reset blocks on dropping out of blocks_to_analyze.  */
+  false                         /* Solved incrementally.  */
 };
 
 
@@ -2668,7 +2685,8 @@ static const struct df_problem problem_CHAIN =
   &problem_RD,                /* Dependent problem.  */
   sizeof (struct df_scan_bb_info),/* Size of entry of block_info array.  */
   TV_DF_CHAIN,                /* Timing variable.  */
-  false                       /* Reset blocks on dropping out of blocks_to_analyze.  */
+  false,                      /* Reset blocks on dropping out of blocks_to_analyze.  */
+  false                       /* Solved incrementally.  */
 };
 
 
@@ -3035,7 +3053,8 @@ static const struct df_problem problem_WORD_LR =
   NULL,                            /* Dependent problem.  */
   sizeof (struct df_word_lr_bb_info),/* Size of entry of block_info array.  */
   TV_DF_WORD_LR,                   /* Timing variable.  */
-  false                            /* Reset blocks on dropping out of blocks_to_analyze.  */
+  false,                           /* Reset blocks on dropping out of blocks_to_analyze.  */
+  false                            /* Solved incrementally.  */
 };
 
 
@@ -3710,7 +3729,8 @@ static const struct df_problem problem_NOTE =
   &problem_LR,                /* Dependent problem.  */
   sizeof (struct df_scan_bb_info),/* Size of entry of block_info array.  */
   TV_DF_NOTE,                 /* Timing variable.  */
-  false                       /* Reset blocks on dropping out of blocks_to_analyze.  */
+  false,                      /* Reset blocks on dropping out of blocks_to_analyze.  */
+  false                       /* Solved incrementally.  */
 };
 
 
@@ -4720,7 +4740,8 @@ static const struct df_problem problem_MD =
   NULL,                       /* Dependent problem.  */
   sizeof (struct df_md_bb_info),/* Size of entry of block_info array.  */
   TV_DF_MD,                   /* Timing variable.  */
-  false                       /* Reset blocks on dropping out of blocks_to_analyze.  */
+  false,                      /* Reset blocks on dropping out of blocks_to_analyze.  */
+  false                       /* Solved incrementally.  */
 };
 
 /* Create a new MD instance and add it to the existing instance
@@ -423,7 +423,8 @@ static const struct df_problem problem_SCAN =
   NULL,                       /* Dependent problem.  */
   sizeof (struct df_scan_bb_info),/* Size of entry of block_info array.  */
   TV_DF_SCAN,                 /* Timing variable.  */
-  false                       /* Reset blocks on dropping out of blocks_to_analyze.  */
+  false,                      /* Reset blocks on dropping out of blocks_to_analyze.  */
+  false                       /* Solved incrementally.  */
 };
 
 
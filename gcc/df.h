@@ -284,6 +284,13 @@ struct df_problem {
   /* True if the df_set_blocks should null out the basic block info if
      this block drops out of df->blocks_to_analyze.  */
   bool free_blocks_on_set_blocks;
+
+  /* True if, once the problem has been solved for the whole function,
+     later solutions are obtained by re-solving only the blocks that
+     can be affected by the blocks that have changed since.  This
+     requires the solution of a block to be a function of the
+     transfer functions and edges alone.  */
+  bool incremental_p;
 };
 
 
@@ -307,6 +314,16 @@ struct dataflow
      defined for any other problem.  */
   bitmap out_of_date_transfer_functions;
 
+  /* For problems solved incrementally, the blocks whose transfer
+     functions or edges have changed since the solution was last
+     computed for the whole function.  NULL if there is no such
+     solution or if the next one has to be computed from scratch.  */
+  bitmap changed_blocks;
+
+  /* While solving incrementally, the blocks whose solution is being
+     recomputed.  NULL otherwise.  */
+  bitmap blocks_to_solve;
+
   /* Other problem specific data that is not on a per basic block
      basis.  The structure is generally defined privately for the
      problem.  The exception being the scanning problem where it is
@@ -970,6 +987,7 @@ extern void df_simple_dataflow (enum df_flow_dir, df_init_function,
 				df_confluence_function_0, df_confluence_function_n,
 				df_transfer_function, bitmap, int *, int);
 extern void df_mark_solutions_dirty (void);
+extern void df_mark_edge_solutions_dirty (edge);
 extern bool df_get_bb_dirty (basic_block);
 extern void df_set_bb_dirty (basic_block);
 extern void df_compact_blocks (void);
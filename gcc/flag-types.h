@@ -257,6 +257,12 @@ enum vtv_priority {
   VTV_PREINIT_PRIORITY  = 2
 };
 
+/* flag_lto_compression_algorithm initialization values.  */
+enum lto_compression_algorithm {
+  LTO_COMPRESSION_ZLIB = 0,
+  LTO_COMPRESSION_ZSTD = 1
+};
+
 /* flag_lto_partition initialization values.  */
 enum lto_partition_model {
   LTO_PARTITION_NONE = 0,
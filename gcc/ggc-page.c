@@ -374,6 +374,23 @@ struct free_object
 };
 #endif
 
+/* A cache of free system pages of one size.  */
+struct free_list
+{
+  /* The cached pages, all of them BYTES long unless this is the
+     fallback list.  */
+  page_entry *free_pages;
+
+  /* The size of the pages on this list, or zero if it is not in use
+     yet.  */
+  size_t bytes;
+};
+
+/* The number of free page lists.  List 0 is the fallback for sizes
+   that did not get a list of their own and may hold pages of any
+   size.  */
+#define NUM_FREE_LISTS 8
+
 /* The rest of the global variables.  */
 static struct ggc_globals
 {
@@ -391,6 +408,11 @@ static struct ggc_globals
   /* Lookup table for associating allocation pages with object addresses.  */
   page_table lookup;
 
+  /* The page of the object most recently marked.  Objects reachable
+     from one another tend to have been allocated together, so checking
+     this first saves most page table lookups during marking.  */
+  page_entry *last_marked_page;
+
   /* The system's page size.  */
   size_t pagesize;
   size_t lg_pagesize;
@@ -418,8 +440,10 @@ static struct ggc_globals
   int dev_zero_fd;
 #endif
 
-  /* A cache of free system pages.  */
-  page_entry *free_pages;
+  /* Caches of free system pages, segregated by page size so that
+     looking for a page of a given size does not have to walk over
+     the pages of all other sizes.  */
+  struct free_list free_lists[NUM_FREE_LISTS];
 
 #ifdef USING_MALLOC_PAGE_GROUPS
   page_group *page_groups;
@@ -576,6 +600,41 @@ push_by_depth (page_entry *p, unsigned long *s)
   G.save_in_use[G.by_depth_in_use++] = s;
 }
 
+/* Return the free page list for pages of ENTRY_SIZE bytes, claiming
+   an unused list if there is no list for that size yet.  */
+
+static struct free_list *
+find_free_list (size_t entry_size)
+{
+  int i;
+
+  for (i = 1; i < NUM_FREE_LISTS; i++)
+    {
+      if (G.free_lists[i].bytes == entry_size)
+	return &G.free_lists[i];
+      if (G.free_lists[i].bytes == 0)
+	{
+	  G.free_lists[i].bytes = entry_size;
+	  return &G.free_lists[i];
+	}
+    }
+  return &G.free_lists[0];
+}
+
+/* The free page list for pages holding objects of each order.  */
+static struct free_list *free_list_by_order[NUM_ORDERS];
+
+/* Like find_free_list, but for the pages of ENTRY_SIZE bytes used for
+   objects of ORDER, which is cheaper as the answer is cached.  */
+
+static inline struct free_list *
+find_free_list_order (unsigned order, size_t entry_size)
+{
+  if (free_list_by_order[order] == NULL)
+    free_list_by_order[order] = find_free_list (entry_size);
+  return free_list_by_order[order];
+}
+
 #if (GCC_VERSION < 3001)
 #define prefetch(X) ((void) X)
 #else
@@ -772,6 +831,7 @@ alloc_page (unsigned order)
   size_t bitmap_size;
   size_t page_entry_size;
   size_t entry_size;
+  struct free_list *free_list;
 #ifdef USING_MALLOC_PAGE_GROUPS
   page_group *group;
 #endif
@@ -787,8 +847,10 @@ alloc_page (unsigned order)
   entry = NULL;
   page = NULL;
 
+  free_list = find_free_list_order (order, entry_size);
+
   /* Check the list of free pages for one we can use.  */
-  for (pp = &G.free_pages, p = *pp; p; pp = &p->next, p = *pp)
+  for (pp = &free_list->free_pages, p = *pp; p; pp = &p->next, p = *pp)
     if (p->bytes == entry_size)
       break;
 
@@ -821,7 +883,7 @@ alloc_page (unsigned order)
       /* We want just one page.  Allocate a bunch of them and put the
 	 extras on the freelist.  (Can only do this optimization with
 	 mmap for backing store.)  */
-      struct page_entry *e, *f = G.free_pages;
+      struct page_entry *e, *f = free_list->free_pages;
       int i, entries = GGC_QUIRE_SIZE;
 
       page = alloc_anon (NULL, G.pagesize * GGC_QUIRE_SIZE, false);
@@ -843,7 +905,7 @@ alloc_page (unsigned order)
 	  f = e;
 	}
 
-      G.free_pages = f;
+      free_list->free_pages = f;
     }
   else
     page = alloc_anon (NULL, entry_size, true);
@@ -903,7 +965,7 @@ alloc_page (unsigned order)
       /* If we allocated multiple pages, put the rest on the free list.  */
       if (multiple_pages)
 	{
-	  struct page_entry *e, *f = G.free_pages;
+	  struct page_entry *e, *f = free_list->free_pages;
 	  for (a = enda - G.pagesize; a != page; a -= G.pagesize)
 	    {
 	      e = XCNEWVAR (struct page_entry, page_entry_size);
@@ -914,7 +976,7 @@ alloc_page (unsigned order)
 	      e->next = f;
 	      f = e;
 	    }
-	  G.free_pages = f;
+	  free_list->free_pages = f;
 	}
     }
 #endif
@@ -988,6 +1050,9 @@ free_page (page_entry *entry)
 
   set_page_table_entry (entry->page, NULL);
 
+  if (G.last_marked_page == entry)
+    G.last_marked_page = NULL;
+
 #ifdef USING_MALLOC_PAGE_GROUPS
   clear_page_group_in_use (entry->group, entry->page);
 #endif
@@ -1010,14 +1075,15 @@ free_page (page_entry *entry)
 
   adjust_depth ();
 
-  entry->next = G.free_pages;
-  G.free_pages = entry;
+  struct free_list *free_list = find_free_list (entry->bytes);
+  entry->next = free_list->free_pages;
+  free_list->free_pages = entry;
 }
 
-/* Release the free page cache to the system.  */
+/* Release the pages cached in FREE_LIST to the system.  */
 
 static void
-release_pages (void)
+do_release_pages (struct free_list *free_list)
 {
 #ifdef USING_MADVISE
   page_entry *p, *start_p;
@@ -1033,7 +1099,7 @@ release_pages (void)
      This does not always work because the free_pages list is only
      approximately sorted. */
 
-  p = G.free_pages;
+  p = free_list->free_pages;
   prev = NULL;
   while (p)
     {
@@ -1062,7 +1128,7 @@ release_pages (void)
 	  if (prev)
 	    prev->next = p;
           else
-            G.free_pages = p;
+            free_list->free_pages = p;
           G.bytes_mapped -= mapped_len;
 	  continue;
         }
@@ -1072,7 +1138,7 @@ release_pages (void)
   /* Now give back the fragmented pages to the OS, but keep the address 
      space to reuse it next time. */
 
-  for (p = G.free_pages; p; )
+  for (p = free_list->free_pages; p; )
     {
       if (p->discarded)
         {
@@ -1108,7 +1174,7 @@ release_pages (void)
   size_t len;
 
   /* Gather up adjacent pages so they are unmapped together.  */
-  p = G.free_pages;
+  p = free_list->free_pages;
 
   while (p)
     {
@@ -1130,14 +1196,13 @@ release_pages (void)
       G.bytes_mapped -= len;
     }
 
-  G.free_pages = NULL;
+  free_list->free_pages = NULL;
 #endif
 #ifdef USING_MALLOC_PAGE_GROUPS
   page_entry **pp, *p;
-  page_group **gp, *g;
 
   /* Remove all pages from free page groups from the list.  */
-  pp = &G.free_pages;
+  pp = &free_list->free_pages;
   while ((p = *pp) != NULL)
     if (p->group->in_use == 0)
       {
@@ -1146,6 +1211,21 @@ release_pages (void)
       }
     else
       pp = &p->next;
+#endif
+}
+
+/* Release the free page caches to the system.  */
+
+static void
+release_pages (void)
+{
+  int i;
+
+  for (i = 0; i < NUM_FREE_LISTS; i++)
+    do_release_pages (&G.free_lists[i]);
+
+#ifdef USING_MALLOC_PAGE_GROUPS
+  page_group **gp, *g;
 
   /* Remove all free page groups, and release the storage.  */
   gp = &G.page_groups;
@@ -1527,10 +1607,17 @@ ggc_set_mark (const void *p)
   unsigned bit, word;
   unsigned long mask;
 
-  /* Look up the page on which the object is alloced.  If the object
-     wasn't allocated by the collector, we'll probably die.  */
-  entry = lookup_page_table_entry (p);
-  gcc_assert (entry);
+  /* Look up the page on which the object is alloced, trying the page
+     of the previously marked object first.  If the object wasn't
+     allocated by the collector, we'll probably die.  */
+  entry = G.last_marked_page;
+  if (entry == NULL
+      || (size_t) ((const char *) p - entry->page) >= entry->bytes)
+    {
+      entry = lookup_page_table_entry (p);
+      gcc_assert (entry);
+      G.last_marked_page = entry;
+    }
 
   /* Calculate the index of the object on the page; this is its bit
      position in the in_use_p bitmap.  */
@@ -1753,8 +1840,9 @@ init_ggc (void)
     e = XCNEW (struct page_entry);
     e->bytes = G.pagesize;
     e->page = p;
-    e->next = G.free_pages;
-    G.free_pages = e;
+    struct free_list *free_list = find_free_list (G.pagesize);
+    e->next = free_list->free_pages;
+    free_list->free_pages = e;
   }
 #endif
 
@@ -2262,6 +2350,33 @@ ggc_print_statistics (void)
   /* Collect and print the statistics common across collectors.  */
   ggc_print_common_statistics (stderr, &stats);
 
+  /* Show how the free page cache is spread over the free lists before
+     it is given back.  */
+  fprintf (stderr, "Free page cache\n");
+  fprintf (stderr, "%-8s %10s  %10s\n", "Size", "Pages", "Cached");
+  for (i = 0; i < NUM_FREE_LISTS; ++i)
+    {
+      page_entry *p;
+      size_t pages = 0;
+      size_t cached = 0;
+
+      for (p = G.free_lists[i].free_pages; p; p = p->next)
+	{
+	  pages++;
+	  if (!p->discarded)
+	    cached += p->bytes;
+	}
+      if (pages == 0)
+	continue;
+
+      if (i == 0)
+	fprintf (stderr, "%-8s", "Other");
+      else
+	fprintf (stderr, "%-8lu", (unsigned long) G.free_lists[i].bytes);
+      fprintf (stderr, " %10lu  %10lu%c\n", (unsigned long) pages,
+	       SCALE (cached), STAT_LABEL (cached));
+    }
+
   /* Release free pages so that we will not count the bytes allocated
      there as part of the total allocated memory.  */
   release_pages ();
@@ -46,19 +46,50 @@ along with GCC; see the file COPYING3.  If not see
    corresponding allocnos see function build_object_conflicts.  */
 static IRA_INT_TYPE **conflicts;
 
-/* Macro to test a conflict of C1 and C2 in `conflicts'.  */
+/* The compressed form of the conflict table used instead of
+   `conflicts' for functions with many allocnos, or NULL.  Element I
+   is the set of conflict ids of the objects conflicting with the
+   object whose conflict id is I.  The sets are sparse bitmaps, so
+   their size depends on the number of runs of conflicting ids rather
+   than on the width of the [OBJECT_MIN, OBJECT_MAX] range, which for
+   long-lived objects can cover most of the objects of the function.  */
+static bitmap_head *conflict_bitmaps;
+
+/* Obstack for the elements of conflict_bitmaps.  */
+static bitmap_obstack conflict_bitmap_obstack;
+
+/* Macro to test a conflict of C1 and C2 in `conflicts' or
+   `conflict_bitmaps'.  */
 #define OBJECTS_CONFLICT_P(C1, C2)					\
   (OBJECT_MIN (C1) <= OBJECT_CONFLICT_ID (C2)				\
    && OBJECT_CONFLICT_ID (C2) <= OBJECT_MAX (C1)			\
-   && TEST_MINMAX_SET_BIT (conflicts[OBJECT_CONFLICT_ID (C1)],		\
-			   OBJECT_CONFLICT_ID (C2),			\
-			   OBJECT_MIN (C1), OBJECT_MAX (C1)))
+   && (conflict_bitmaps != NULL						\
+       ? bitmap_bit_p (&conflict_bitmaps[OBJECT_CONFLICT_ID (C1)],	\
+		       OBJECT_CONFLICT_ID (C2))				\
+       : TEST_MINMAX_SET_BIT (conflicts[OBJECT_CONFLICT_ID (C1)],	\
+			      OBJECT_CONFLICT_ID (C2),			\
+			      OBJECT_MIN (C1), OBJECT_MAX (C1))))
+
+/* Record in the conflict table that the object with conflict id ID
+   conflicts with OBJ.  Return true if this is a new conflict.  */
+static inline bool
+set_object_conflict_bit (ira_object_t obj, int id)
+{
+  int obj_id = OBJECT_CONFLICT_ID (obj);
+
+  if (conflict_bitmaps != NULL)
+    return bitmap_set_bit (&conflict_bitmaps[obj_id], id);
+  SET_MINMAX_SET_BIT (conflicts[obj_id], id, OBJECT_MIN (obj),
+		      OBJECT_MAX (obj));
+  return true;
+}
 
 
 /* Record a conflict between objects OBJ1 and OBJ2.  If necessary,
    canonicalize the conflict by recording it for lower-order subobjects
-   of the corresponding allocnos.  */
-static void
+   of the corresponding allocnos.  Return true if the conflict was not
+   recorded before.  */
+static bool
 record_object_conflict (ira_object_t obj1, ira_object_t obj2)
 {
   ira_allocno_t a1 = OBJECT_ALLOCNO (obj1);
@@ -79,22 +110,48 @@ record_object_conflict (ira_object_t obj1, ira_object_t obj2)
   id1 = OBJECT_CONFLICT_ID (obj1);
   id2 = OBJECT_CONFLICT_ID (obj2);
 
-  SET_MINMAX_SET_BIT (conflicts[id1], id2, OBJECT_MIN (obj1),
-		      OBJECT_MAX (obj1));
-  SET_MINMAX_SET_BIT (conflicts[id2], id1, OBJECT_MIN (obj2),
-		      OBJECT_MAX (obj2));
+  set_object_conflict_bit (obj2, id1);
+  return set_object_conflict_bit (obj1, id2);
+}
+
+/* Free the conflict table built by build_conflict_bit_table.  */
+static void
+free_conflict_table (void)
+{
+  ira_object_t obj;
+  ira_object_iterator oi;
+
+  if (conflict_bitmaps != NULL)
+    {
+      bitmap_obstack_release (&conflict_bitmap_obstack);
+      ira_free (conflict_bitmaps);
+      conflict_bitmaps = NULL;
+      return;
+    }
+  /* Some bit vectors of the table became the conflict bit vectors of
+     the objects (see function build_object_conflicts for details).  */
+  FOR_EACH_OBJECT (obj, oi)
+    {
+      if (OBJECT_CONFLICT_ARRAY (obj) != conflicts[OBJECT_CONFLICT_ID (obj)])
+	ira_free (conflicts[OBJECT_CONFLICT_ID (obj)]);
+    }
+  ira_free (conflicts);
 }
 
 /* Build allocno conflict table by processing allocno live ranges.
    Return true if the table was built.  The table is not built if it
-   is too big.  */
+   is too big.  The table is compressed into conflict_bitmaps if the
+   function has more than IRA_MAX_DENSE_CONFLICT_ALLOCNOS allocnos or
+   if the min-max bit vectors would need more memory than
+   IRA_MAX_CONFLICT_TABLE_SIZE.  */
 static bool
 build_conflict_bit_table (void)
 {
   int i;
   unsigned int j;
   enum reg_class aclass;
-  int object_set_words, allocated_words_num, conflict_bit_vec_words_num;
+  int object_set_words, conflict_bit_vec_words_num;
+  int64_t allocated_words_num, max_table_size, new_conflicts_num;
   live_range_t r;
   ira_allocno_t allocno;
   ira_allocno_iterator ai;
@@ -102,6 +159,7 @@ build_conflict_bit_table (void)
   ira_object_t obj;
   ira_allocno_object_iterator aoi;
 
+  max_table_size = (int64_t) IRA_MAX_CONFLICT_TABLE_SIZE * 1024 * 1024;
   allocated_words_num = 0;
   FOR_EACH_ALLOCNO (allocno, ai)
     FOR_EACH_ALLOCNO_OBJECT (allocno, obj, aoi)
@@ -112,49 +170,57 @@ build_conflict_bit_table (void)
 	  = ((OBJECT_MAX (obj) - OBJECT_MIN (obj) + IRA_INT_BITS)
 	     / IRA_INT_BITS);
 	allocated_words_num += conflict_bit_vec_words_num;
-	if ((uint64_t) allocated_words_num * sizeof (IRA_INT_TYPE)
-	    > (uint64_t) IRA_MAX_CONFLICT_TABLE_SIZE * 1024 * 1024)
-	  {
-	    if (internal_flag_ira_verbose > 0 && ira_dump_file != NULL)
-	      fprintf
-		(ira_dump_file,
-		 "+++Conflict table will be too big(>%dMB) -- don't use it\n",
-		 IRA_MAX_CONFLICT_TABLE_SIZE);
-	    return false;
-	  }
       }
 
-  conflicts = (IRA_INT_TYPE **) ira_allocate (sizeof (IRA_INT_TYPE *)
-					      * ira_objects_num);
-  allocated_words_num = 0;
-  FOR_EACH_ALLOCNO (allocno, ai)
-    FOR_EACH_ALLOCNO_OBJECT (allocno, obj, aoi)
-      {
-	int id = OBJECT_CONFLICT_ID (obj);
-	if (OBJECT_MAX (obj) < OBJECT_MIN (obj))
+  object_set_words = (ira_objects_num + IRA_INT_BITS - 1) / IRA_INT_BITS;
+  if (ira_allocnos_num > IRA_MAX_DENSE_CONFLICT_ALLOCNOS
+      || (allocated_words_num * (int64_t) sizeof (IRA_INT_TYPE)
+	  > max_table_size))
+    {
+      conflict_bitmaps
+	= (bitmap_head *) ira_allocate (sizeof (bitmap_head)
+					* ira_objects_num);
+      bitmap_obstack_initialize (&conflict_bitmap_obstack);
+      for (i = 0; i < ira_objects_num; i++)
+	{
+	  bitmap_initialize (&conflict_bitmaps[i], &conflict_bitmap_obstack);
+	  /* The conflicts are found in no particular order of ids.  */
+	  bitmap_tree_view (&conflict_bitmaps[i]);
+	}
+    }
+  else
+    {
+      conflicts = (IRA_INT_TYPE **) ira_allocate (sizeof (IRA_INT_TYPE *)
+						  * ira_objects_num);
+      FOR_EACH_ALLOCNO (allocno, ai)
+	FOR_EACH_ALLOCNO_OBJECT (allocno, obj, aoi)
 	  {
-	    conflicts[id] = NULL;
-	    continue;
+	    int id = OBJECT_CONFLICT_ID (obj);
+	    if (OBJECT_MAX (obj) < OBJECT_MIN (obj))
+	      {
+		conflicts[id] = NULL;
+		continue;
+	      }
+	    conflict_bit_vec_words_num
+	      = ((OBJECT_MAX (obj) - OBJECT_MIN (obj) + IRA_INT_BITS)
+		 / IRA_INT_BITS);
+	    conflicts[id]
+	      = (IRA_INT_TYPE *) ira_allocate (sizeof (IRA_INT_TYPE)
+					       * conflict_bit_vec_words_num);
+	    memset (conflicts[id], 0,
+		    sizeof (IRA_INT_TYPE) * conflict_bit_vec_words_num);
 	  }
-	conflict_bit_vec_words_num
-	  = ((OBJECT_MAX (obj) - OBJECT_MIN (obj) + IRA_INT_BITS)
-	     / IRA_INT_BITS);
-	allocated_words_num += conflict_bit_vec_words_num;
-	conflicts[id]
-	  = (IRA_INT_TYPE *) ira_allocate (sizeof (IRA_INT_TYPE)
-					   * conflict_bit_vec_words_num);
-	memset (conflicts[id], 0,
-		sizeof (IRA_INT_TYPE) * conflict_bit_vec_words_num);
-      }
 
-  object_set_words = (ira_objects_num + IRA_INT_BITS - 1) / IRA_INT_BITS;
-  if (internal_flag_ira_verbose > 0 && ira_dump_file != NULL)
-    fprintf
-      (ira_dump_file,
-       "+++Allocating %ld bytes for conflict table (uncompressed size %ld)\n",
-       (long) allocated_words_num * sizeof (IRA_INT_TYPE),
-       (long) object_set_words * ira_objects_num * sizeof (IRA_INT_TYPE));
+      if (internal_flag_ira_verbose > 0 && ira_dump_file != NULL)
+	fprintf
+	  (ira_dump_file,
+	   "+++Allocating %ld bytes for conflict table "
+	   "(uncompressed size %ld)\n",
+	   (long) allocated_words_num * sizeof (IRA_INT_TYPE),
+	   (long) object_set_words * ira_objects_num * sizeof (IRA_INT_TYPE));
+    }
 
+  new_conflicts_num = 0;
   objects_live = sparseset_alloc (ira_objects_num);
   for (i = 0; i < ira_max_point; i++)
     {
@@ -177,7 +243,8 @@ build_conflict_bit_table (void)
 		  /* Don't set up conflict for the allocno with itself.  */
 		  && live_a != allocno)
 		{
-		  record_object_conflict (obj, live_obj);
+		  if (record_object_conflict (obj, live_obj))
+		    new_conflicts_num++;
 		}
 	    }
 	  sparseset_set_bit (objects_live, id);
@@ -185,11 +252,56 @@ build_conflict_bit_table (void)
 
       for (r = ira_finish_point_ranges[i]; r != NULL; r = r->finish_next)
 	sparseset_clear_bit (objects_live, OBJECT_CONFLICT_ID (r->object));
+
+      /* The size of the compressed table is not known in advance, so
+	 check it from time to time as it grows.  */
+      if (conflict_bitmaps != NULL
+	  && (new_conflicts_num >= (1 << 16) || i == ira_max_point - 1))
+	{
+	  new_conflicts_num = 0;
+	  if ((int64_t) obstack_memory_used (&conflict_bitmap_obstack.obstack)
+	      > max_table_size)
+	    {
+	      if (internal_flag_ira_verbose > 0 && ira_dump_file != NULL)
+		fprintf
+		  (ira_dump_file,
+		   "+++Compressed conflict table is too big(>%dMB) "
+		   "-- don't use it\n",
+		   IRA_MAX_CONFLICT_TABLE_SIZE);
+	      sparseset_free (objects_live);
+	      free_conflict_table ();
+	      return false;
+	    }
+	}
     }
   sparseset_free (objects_live);
+
+  if (conflict_bitmaps != NULL)
+    {
+      long compressed_size = (long) sizeof (bitmap_head) * ira_objects_num;
+      bitmap_element *elt;
+
+      /* From now on the sets are mostly iterated.  */
+      for (i = 0; i < ira_objects_num; i++)
+	{
+	  bitmap_list_view (&conflict_bitmaps[i]);
+	  for (elt = conflict_bitmaps[i].first; elt != NULL; elt = elt->next)
+	    compressed_size += sizeof (bitmap_element);
+	}
+      if (internal_flag_ira_verbose > 0 && ira_dump_file != NULL)
+	fprintf
+	  (ira_dump_file,
+	   "+++Allocating %ld bytes for compressed conflict table "
+	   "(min-max size %ld, saved %ld, uncompressed size %ld)\n",
+	   compressed_size,
+	   (long) allocated_words_num * sizeof (IRA_INT_TYPE),
+	   (long) allocated_words_num * sizeof (IRA_INT_TYPE)
+	   - compressed_size,
+	   (long) object_set_words * ira_objects_num * sizeof (IRA_INT_TYPE));
+    }
   return true;
 }
-
+
 /* Return true iff allocnos A1 and A2 cannot be allocated to the same
    register due to conflicts.  */
 
@@ -461,25 +573,27 @@ static ira_object_t *collected_conflict_objects;
 static void
 build_object_conflicts (ira_object_t obj)
 {
-  int i, px, parent_num;
+  int i, px;
+  unsigned int k;
   ira_allocno_t parent_a, another_parent_a;
   ira_object_t parent_obj;
   ira_allocno_t a = OBJECT_ALLOCNO (obj);
   IRA_INT_TYPE *object_conflicts;
   minmax_set_iterator asi;
-  int parent_min, parent_max ATTRIBUTE_UNUSED;
+  bitmap_iterator bi;
 
-  object_conflicts = conflicts[OBJECT_CONFLICT_ID (obj)];
+  object_conflicts = NULL;
   px = 0;
-  FOR_EACH_BIT_IN_MINMAX_SET (object_conflicts,
-			      OBJECT_MIN (obj), OBJECT_MAX (obj), i, asi)
+  if (conflict_bitmaps != NULL)
+    EXECUTE_IF_SET_IN_BITMAP (&conflict_bitmaps[OBJECT_CONFLICT_ID (obj)],
+			      0, k, bi)
+      collected_conflict_objects[px++] = ira_object_id_map[k];
+  else
     {
-      ira_object_t another_obj = ira_object_id_map[i];
-      ira_allocno_t another_a = OBJECT_ALLOCNO (obj);
-
-      ira_assert (ira_reg_classes_intersect_p
-		  [ALLOCNO_CLASS (a)][ALLOCNO_CLASS (another_a)]);
-      collected_conflict_objects[px++] = another_obj;
+      object_conflicts = conflicts[OBJECT_CONFLICT_ID (obj)];
+      FOR_EACH_BIT_IN_MINMAX_SET (object_conflicts,
+				  OBJECT_MIN (obj), OBJECT_MAX (obj), i, asi)
+	collected_conflict_objects[px++] = ira_object_id_map[i];
     }
   if (ira_conflict_vector_profitable_p (obj, px))
     {
@@ -494,13 +608,31 @@ build_object_conflicts (ira_object_t obj)
     {
       int conflict_bit_vec_words_num;
 
-      OBJECT_CONFLICT_ARRAY (obj) = object_conflicts;
       if (OBJECT_MAX (obj) < OBJECT_MIN (obj))
 	conflict_bit_vec_words_num = 0;
       else
 	conflict_bit_vec_words_num
 	  = ((OBJECT_MAX (obj) - OBJECT_MIN (obj) + IRA_INT_BITS)
 	     / IRA_INT_BITS);
+      if (conflict_bitmaps != NULL && conflict_bit_vec_words_num != 0)
+	{
+	  /* The compressed table is freed after the conflicts are built,
+	     so the bit vector has to be created here.  */
+	  object_conflicts
+	    = (IRA_INT_TYPE *) ira_allocate (sizeof (IRA_INT_TYPE)
+					     * conflict_bit_vec_words_num);
+	  memset (object_conflicts, 0,
+		  sizeof (IRA_INT_TYPE) * conflict_bit_vec_words_num);
+	  for (i = 0; i < px; i++)
+	    {
+	      ira_object_t another_obj = collected_conflict_objects[i];
+
+	      SET_MINMAX_SET_BIT (object_conflicts,
+				  OBJECT_CONFLICT_ID (another_obj),
+				  OBJECT_MIN (obj), OBJECT_MAX (obj));
+	    }
+	}
+      OBJECT_CONFLICT_ARRAY (obj) = object_conflicts;
       OBJECT_CONFLICT_ARRAY_SIZE (obj)
 	= conflict_bit_vec_words_num * sizeof (IRA_INT_TYPE);
     }
@@ -511,13 +643,9 @@ build_object_conflicts (ira_object_t obj)
   ira_assert (ALLOCNO_CLASS (a) == ALLOCNO_CLASS (parent_a));
   ira_assert (ALLOCNO_NUM_OBJECTS (a) == ALLOCNO_NUM_OBJECTS (parent_a));
   parent_obj = ALLOCNO_OBJECT (parent_a, OBJECT_SUBWORD (obj));
-  parent_num = OBJECT_CONFLICT_ID (parent_obj);
-  parent_min = OBJECT_MIN (parent_obj);
-  parent_max = OBJECT_MAX (parent_obj);
-  FOR_EACH_BIT_IN_MINMAX_SET (object_conflicts,
-			      OBJECT_MIN (obj), OBJECT_MAX (obj), i, asi)
+  for (i = 0; i < px; i++)
     {
-      ira_object_t another_obj = ira_object_id_map[i];
+      ira_object_t another_obj = collected_conflict_objects[i];
       ira_allocno_t another_a = OBJECT_ALLOCNO (another_obj);
       int another_word = OBJECT_SUBWORD (another_obj);
 
@@ -532,10 +660,10 @@ build_object_conflicts (ira_object_t obj)
 		  == ALLOCNO_CLASS (another_parent_a));
       ira_assert (ALLOCNO_NUM_OBJECTS (another_a)
 		  == ALLOCNO_NUM_OBJECTS (another_parent_a));
-      SET_MINMAX_SET_BIT (conflicts[parent_num],
-			  OBJECT_CONFLICT_ID (ALLOCNO_OBJECT (another_parent_a,
-							      another_word)),
-			  parent_min, parent_max);
+      set_object_conflict_bit (parent_obj,
+			       OBJECT_CONFLICT_ID
+			       (ALLOCNO_OBJECT (another_parent_a,
+						another_word)));
     }
 }
 
@@ -707,9 +835,6 @@ ira_build_conflicts (void)
       ira_conflicts_p = build_conflict_bit_table ();
       if (ira_conflicts_p)
 	{
-	  ira_object_t obj;
-	  ira_object_iterator oi;
-
 	  build_conflicts ();
 	  ira_traverse_loop_tree (true, ira_loop_tree_root, add_copies, NULL);
 	  /* We need finished conflict table for the subsequent call.  */
@@ -717,14 +842,8 @@ ira_build_conflicts (void)
 	      || flag_ira_region == IRA_REGION_MIXED)
 	    propagate_copies ();
 
-	  /* Now we can free memory for the conflict table (see function
-	     build_object_conflicts for details).  */
-	  FOR_EACH_OBJECT (obj, oi)
-	    {
-	      if (OBJECT_CONFLICT_ARRAY (obj) != conflicts[OBJECT_CONFLICT_ID (obj)])
-		ira_free (conflicts[OBJECT_CONFLICT_ID (obj)]);
-	    }
-	  ira_free (conflicts);
+	  /* Now we can free memory for the conflict table.  */
+	  free_conflict_table ();
 	}
     }
   base = base_reg_class (VOIDmode, ADDR_SPACE_GENERIC, ADDRESS, SCRATCH);
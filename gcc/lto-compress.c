@@ -32,17 +32,23 @@ along with GCC; see the file COPYING3.  If not see
    zlib.h needs to be included after, rather than before, config.h and
    system.h.  */
 #include <zlib.h>
+#ifdef HAVE_ZSTD_H
+#include <zstd.h>
+#endif
 #include "lto-compress.h"
 #include "timevar.h"
 
 /* Compression stream structure, holds the flush callback and opaque token,
-   the buffered data, and a note of whether compressing or uncompressing.  */
+   the buffered data, and a note of whether compressing or uncompressing.
+   When uncompressing data that was passed in a single block, INPUT points
+   to that block and BUFFER is not used.  */
 
 struct lto_compression_stream
 {
   void (*callback) (const char *, unsigned, void *);
   void *opaque;
   char *buffer;
+  const char *input;
   size_t bytes;
   size_t allocation;
   bool is_compression;
@@ -163,10 +169,10 @@ lto_compress_block (struct lto_compression_stream *stream,
   lto_stats.num_output_il_bytes += num_chars;
 }
 
-/* Finalize STREAM compression, and free stream allocations.  */
+/* Compress STREAM using zlib, and free stream allocations.  */
 
-void
-lto_end_compression (struct lto_compression_stream *stream)
+static void
+lto_compression_zlib (struct lto_compression_stream *stream)
 {
   unsigned char *cursor = (unsigned char *) stream->buffer;
   size_t remaining = stream->bytes;
@@ -226,6 +232,68 @@ lto_end_compression (struct lto_compression_stream *stream)
   timevar_pop (TV_IPA_LTO_COMPRESS);
 }
 
+#ifdef HAVE_ZSTD_H
+/* Return a zstd compression level that zstd will not reject.  A negative
+   level selects the zstd default, and levels above the strongest one zstd
+   supports are clamped to it.  */
+
+static int
+lto_normalized_zstd_level (void)
+{
+  int level = flag_lto_compression_level;
+
+  if (level < 0)
+    level = 0;
+  else if (level > ZSTD_maxCLevel ())
+    level = ZSTD_maxCLevel ();
+
+  return level;
+}
+
+/* Compress STREAM using zstd, and free stream allocations.  The whole
+   stream is compressed into a single zstd frame.  */
+
+static void
+lto_compression_zstd (struct lto_compression_stream *stream)
+{
+  const size_t outbuf_length = ZSTD_compressBound (stream->bytes);
+  char *outbuf = (char *) xmalloc (outbuf_length);
+  size_t compressed_bytes;
+
+  timevar_push (TV_IPA_LTO_COMPRESS);
+
+  compressed_bytes = ZSTD_compress (outbuf, outbuf_length,
+				    stream->buffer, stream->bytes,
+				    lto_normalized_zstd_level ());
+  if (ZSTD_isError (compressed_bytes))
+    internal_error ("compressed stream: %s",
+		    ZSTD_getErrorName (compressed_bytes));
+
+  stream->callback (outbuf, compressed_bytes, stream->opaque);
+  lto_stats.num_compressed_il_bytes += compressed_bytes;
+
+  lto_destroy_compression_stream (stream);
+  free (outbuf);
+  timevar_pop (TV_IPA_LTO_COMPRESS);
+}
+#endif
+
+/* Finalize STREAM compression with the algorithm selected by
+   -flto-compression-algorithm, and free stream allocations.  */
+
+void
+lto_end_compression (struct lto_compression_stream *stream)
+{
+#ifdef HAVE_ZSTD_H
+  if (flag_lto_compression_algorithm == LTO_COMPRESSION_ZSTD)
+    {
+      lto_compression_zstd (stream);
+      return;
+    }
+#endif
+  lto_compression_zlib (stream);
+}
+
 /* Return a new uncompression stream, with CALLBACK flush function passed
    OPAQUE token.  */
 
@@ -244,21 +312,41 @@ lto_uncompress_block (struct lto_compression_stream *stream,
 {
   gcc_assert (!stream->is_compression);
 
-  lto_append_to_compression_stream (stream, base, num_chars);
+  if (stream->bytes == 0)
+    {
+      /* Uncompress a single block in place rather than copying it.  */
+      stream->input = base;
+      stream->bytes = num_chars;
+    }
+  else
+    {
+      if (stream->input)
+	{
+	  const char *input = stream->input;
+	  size_t bytes = stream->bytes;
+
+	  stream->input = NULL;
+	  stream->bytes = 0;
+	  lto_append_to_compression_stream (stream, input, bytes);
+	}
+      lto_append_to_compression_stream (stream, base, num_chars);
+    }
   lto_stats.num_input_il_bytes += num_chars;
 }
 
-/* Finalize STREAM uncompression, and free stream allocations.
+/* Uncompress the SIZE bytes at DATA from a zlib STREAM, and free stream
+   allocations.
 
    Because of the way LTO IL streams are compressed, there may be several
    concatenated compressed segments in the accumulated data, so for this
    function we iterate decompressions until no data remains.  */
 
-void
-lto_end_uncompression (struct lto_compression_stream *stream)
+static void
+lto_uncompression_zlib (struct lto_compression_stream *stream,
+			const unsigned char *data, size_t size)
 {
-  unsigned char *cursor = (unsigned char *) stream->buffer;
-  size_t remaining = stream->bytes;
+  unsigned char *cursor = CONST_CAST (unsigned char *, data);
+  size_t remaining = size;
   const size_t outbuf_length = Z_BUFFER_LENGTH;
   unsigned char *outbuf = (unsigned char *) xmalloc (outbuf_length);
   size_t uncompressed_bytes = 0;
@@ -318,3 +406,95 @@ lto_end_uncompression (struct lto_compression_stream *stream)
   free (outbuf);
   timevar_pop (TV_IPA_LTO_DECOMPRESS);
 }
+
+/* The magic number that starts every zstd frame.  No zlib stream can start
+   with these bytes, since its header checksum would not match.  */
+
+static const unsigned char zstd_magic[4] = { 0x28, 0xb5, 0x2f, 0xfd };
+
+#ifdef HAVE_ZSTD_H
+/* Uncompress the SIZE bytes at DATA from a zstd STREAM, and free stream
+   allocations.
+
+   lto_compression_zstd writes a single frame, but like the zlib path we
+   accept several concatenated frames, decompressing them in turn.  */
+
+static void
+lto_uncompression_zstd (struct lto_compression_stream *stream,
+			const unsigned char *data, size_t size)
+{
+  const size_t outbuf_length = ZSTD_DStreamOutSize ();
+  char *outbuf = (char *) xmalloc (outbuf_length);
+  ZSTD_DStream *dstream = ZSTD_createDStream ();
+  ZSTD_inBuffer in_buffer = { data, size, 0 };
+  size_t status;
+
+  timevar_push (TV_IPA_LTO_DECOMPRESS);
+
+  if (dstream == NULL)
+    internal_error ("compressed stream: cannot allocate zstd stream");
+  status = ZSTD_initDStream (dstream);
+  if (ZSTD_isError (status))
+    internal_error ("compressed stream: %s", ZSTD_getErrorName (status));
+
+  for (;;)
+    {
+      ZSTD_outBuffer out_buffer = { outbuf, outbuf_length, 0 };
+
+      status = ZSTD_decompressStream (dstream, &out_buffer, &in_buffer);
+      if (ZSTD_isError (status))
+	internal_error ("compressed stream: %s", ZSTD_getErrorName (status));
+
+      stream->callback (outbuf, out_buffer.pos, stream->opaque);
+      lto_stats.num_uncompressed_il_bytes += out_buffer.pos;
+
+      if (status == 0)
+	{
+	  /* A frame has been fully decoded and flushed.  */
+	  if (in_buffer.pos == in_buffer.size)
+	    break;
+	  status = ZSTD_initDStream (dstream);
+	  if (ZSTD_isError (status))
+	    internal_error ("compressed stream: %s",
+			    ZSTD_getErrorName (status));
+	}
+      else if (in_buffer.pos == in_buffer.size
+	       && out_buffer.pos < out_buffer.size)
+	internal_error ("compressed stream: truncated zstd frame");
+    }
+
+  ZSTD_freeDStream (dstream);
+  lto_destroy_compression_stream (stream);
+  free (outbuf);
+  timevar_pop (TV_IPA_LTO_DECOMPRESS);
+}
+#endif
+
+/* Finalize STREAM uncompression, and free stream allocations.  The
+   algorithm used to compress the data is recognized from its first
+   bytes, so objects written with either algorithm can be read back.  */
+
+void
+lto_end_uncompression (struct lto_compression_stream *stream)
+{
+  const unsigned char *data
+    = (const unsigned char *) (stream->input
+			       ? stream->input : stream->buffer);
+  size_t size = stream->bytes;
+
+  gcc_assert (!stream->is_compression);
+
+  if (size >= sizeof (zstd_magic)
+      && memcmp (data, zstd_magic, sizeof (zstd_magic)) == 0)
+    {
+#ifdef HAVE_ZSTD_H
+      lto_uncompression_zstd (stream, data, size);
+      return;
+#else
+      fatal_error (input_location,
+		   "compiler does not support zstd LTO compression");
+#endif
+    }
+
+  lto_uncompression_zlib (stream, data, size);
+}
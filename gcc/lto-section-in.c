@@ -95,6 +95,7 @@ struct lto_buffer
 {
   char *data;
   size_t length;
+  size_t allocation;
 };
 
 /* Compression callback, append LENGTH bytes from DATA to the buffer pointed
@@ -105,7 +106,13 @@ lto_append_data (const char *data, unsigned length, void *opaque)
 {
   struct lto_buffer *buffer = (struct lto_buffer *) opaque;
 
-  buffer->data = (char *) xrealloc (buffer->data, buffer->length + length);
+  /* Grow the buffer geometrically; it is fed in small chunks.  */
+  if (buffer->allocation < buffer->length + length)
+    {
+      buffer->allocation = MAX (buffer->allocation * 2,
+				buffer->length + length);
+      buffer->data = (char *) xrealloc (buffer->data, buffer->allocation);
+    }
   memcpy (buffer->data + buffer->length, data, length);
   buffer->length += length;
 }
@@ -158,6 +165,7 @@ lto_get_section_data (struct lto_file_decl_data *file_data,
 
       buffer.data = (char *) header;
       buffer.length = header_length;
+      buffer.allocation = header_length;
 
       stream = lto_start_uncompression (lto_append_data, &buffer);
       lto_uncompress_block (stream, data, *len);
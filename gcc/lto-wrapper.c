@@ -48,6 +48,10 @@ along with GCC; see the file COPYING3.  If not see
 #include "simple-object.h"
 #include "lto-section-names.h"
 #include "collect-utils.h"
+#include "md5.h"
+#include "version.h"
+#include <dirent.h>
+#include <utime.h>
 
 /* Environment variable, used for passing the names of offload targets from GCC
    driver to lto-wrapper.  */
@@ -71,6 +75,14 @@ static char **offload_names;
 static char *offload_objects_file_name;
 static char *makefile;
 
+/* Directory given by -flto-incremental=, holding LTRANS object files of
+   previous links named after a hash of their input, or NULL.  */
+static const char *ltrans_cache_dir;
+
+/* Maximum number of object files kept in ltrans_cache_dir, given by
+   -flto-incremental-cache-size=, or zero for no limit.  */
+static unsigned long ltrans_cache_size = 2048;
+
 const char tool_name[] = "lto-wrapper";
 
 /* Delete tempfiles.  Called from utils_cleanup.  */
@@ -594,6 +606,8 @@ append_linker_options (obstack *argv_obstack, struct cl_decoded_option *opts,
 	case OPT_o:
 	case OPT_flto_:
 	case OPT_flto:
+	case OPT_flto_incremental_:
+	case OPT_flto_incremental_cache_size_:
 	  /* We've handled these LTO options, do not pass them on.  */
 	  continue;
 
@@ -820,26 +834,202 @@ compile_images_for_offload_targets (unsigned in_argc, char *in_argv[],
   free_array_of_ptrs ((void **) names, num_targets);
 }
 
-/* Copy a file from SRC to DEST.  */
+/* Copy a file from SRC to DEST and return true.  If that fails, the
+   problem is a fatal error if FATAL, and otherwise a warning after which
+   false is returned.  */
 
-static void
-copy_file (const char *dest, const char *src)
+static bool
+copy_file (const char *dest, const char *src, bool fatal = true)
 {
-  FILE *d = fopen (dest, "wb");
-  FILE *s = fopen (src, "rb");
+  diagnostic_t kind = fatal ? DK_FATAL : DK_WARNING;
+  FILE *d, *s;
   char buffer[512];
-  while (!feof (s))
+  bool ok = true;
+
+  s = fopen (src, "rb");
+  if (!s)
+    {
+      emit_diagnostic (kind, input_location, 0, "cannot open %s: %m", src);
+      return false;
+    }
+  d = fopen (dest, "wb");
+  if (!d)
+    {
+      emit_diagnostic (kind, input_location, 0, "cannot open %s: %m", dest);
+      fclose (s);
+      return false;
+    }
+  while (ok && !feof (s))
     {
       size_t len = fread (buffer, 1, 512, s);
       if (ferror (s) != 0)
-	fatal_error (input_location, "reading input file");
-      if (len > 0)
 	{
-	  fwrite (buffer, 1, len, d);
-	  if (ferror (d) != 0)
-	    fatal_error (input_location, "writing output file");
+	  emit_diagnostic (kind, input_location, 0, "reading %s: %m", src);
+	  ok = false;
+	}
+      else if (len > 0 && fwrite (buffer, 1, len, d) != len)
+	{
+	  emit_diagnostic (kind, input_location, 0, "writing %s: %m", dest);
+	  ok = false;
+	}
+    }
+  fclose (s);
+  if (fclose (d) != 0 && ok)
+    {
+      emit_diagnostic (kind, input_location, 0, "writing %s: %m", dest);
+      ok = false;
+    }
+  return ok;
+}
+
+/* Return the name of the LTRANS cache entry for the LTRANS unit compiled
+   from INPUT_NAME with the ARGC options in ARGV.  The entry is named after
+   the MD5 sum of the compiler version, the options and the contents of
+   INPUT_NAME, which holds everything the LTRANS unit is compiled from.
+   WPA writes INPUT_NAME with a fixed random seed and without the names
+   of temporary files, so its contents only change with the partition.  */
+
+static char *
+ltrans_cache_entry (int argc, const char **argv, const char *input_name)
+{
+  struct md5_ctx ctx;
+  unsigned char digest[16];
+  char hex[2 * sizeof (digest) + 1];
+  char buffer[4096];
+  size_t len;
+  FILE *f;
+  int i;
+
+  md5_init_ctx (&ctx);
+  md5_process_bytes (version_string, strlen (version_string) + 1, &ctx);
+  for (i = 0; i < argc; i++)
+    {
+      /* The dump directory does not affect the generated code.  */
+      if (strcmp (argv[i], "-dumpdir") == 0)
+	{
+	  i++;
+	  continue;
+	}
+      md5_process_bytes (argv[i], strlen (argv[i]) + 1, &ctx);
+    }
+
+  f = fopen (input_name, "rb");
+  if (!f)
+    fatal_error (input_location, "cannot open %s: %m", input_name);
+  while ((len = fread (buffer, 1, sizeof (buffer), f)) > 0)
+    md5_process_bytes (buffer, len, &ctx);
+  if (ferror (f) != 0)
+    fatal_error (input_location, "reading input file");
+  fclose (f);
+  md5_finish_ctx (&ctx, digest);
+
+  for (i = 0; i < (int) sizeof (digest); i++)
+    sprintf (&hex[2 * i], "%02x", digest[i]);
+  return concat (ltrans_cache_dir, "/", hex, ".ltrans.o", NULL);
+}
+
+/* Store the LTRANS object file OUTPUT_NAME as cache entry ENTRY.  The copy
+   is made under a temporary name and then renamed, so that concurrent links
+   sharing the cache never see a partially written entry.  The cache is only
+   an optimization, so failing to store the entry is merely a warning.  */
+
+static void
+ltrans_cache_store (const char *entry, const char *output_name)
+{
+  char suffix[32];
+  char *tmp;
+
+  sprintf (suffix, ".%ld.tmp", (long) getpid ());
+  tmp = concat (entry, suffix, NULL);
+  if (!copy_file (tmp, output_name, /*fatal=*/false))
+    unlink (tmp);
+  else if (rename (tmp, entry) != 0)
+    {
+      warning (0, "renaming %s to %s: %m", tmp, entry);
+      unlink (tmp);
+    }
+  else if (verbose)
+    fprintf (stderr, "[Caching LTRANS %s as %s]\n", output_name, entry);
+  free (tmp);
+}
+
+/* An entry of the LTRANS cache, for ltrans_cache_trim.  */
+
+struct ltrans_cache_file
+{
+  char *name;
+  time_t mtime;
+};
+
+/* Compare the LTRANS cache entries P1 and P2 by their modification time,
+   oldest first.  */
+
+static int
+ltrans_cache_file_cmp (const void *p1, const void *p2)
+{
+  const struct ltrans_cache_file *f1 = (const struct ltrans_cache_file *) p1;
+  const struct ltrans_cache_file *f2 = (const struct ltrans_cache_file *) p2;
+
+  if (f1->mtime != f2->mtime)
+    return f1->mtime < f2->mtime ? -1 : 1;
+  return strcmp (f1->name, f2->name);
+}
+
+/* Remove the least recently used entries from the LTRANS cache until it
+   holds at most ltrans_cache_size of them.  Reusing an entry updates its
+   modification time, so that is when it was last used.  Entries that
+   another link removes meanwhile are simply skipped.  */
+
+static void
+ltrans_cache_trim (void)
+{
+  static const char suffix[] = ".ltrans.o";
+  struct ltrans_cache_file *files = NULL;
+  unsigned long nfiles = 0, i;
+  struct dirent *d;
+  struct stat st;
+  DIR *dir;
+
+  if (ltrans_cache_size == 0)
+    return;
+  dir = opendir (ltrans_cache_dir);
+  if (!dir)
+    return;
+  while ((d = readdir (dir)) != NULL)
+    {
+      size_t len = strlen (d->d_name);
+      char *name;
+
+      if (len <= sizeof (suffix) - 1
+	  || strcmp (d->d_name + len - (sizeof (suffix) - 1), suffix) != 0)
+	continue;
+      name = concat (ltrans_cache_dir, "/", d->d_name, NULL);
+      if (stat (name, &st) != 0)
+	{
+	  free (name);
+	  continue;
+	}
+      files = XRESIZEVEC (struct ltrans_cache_file, files, nfiles + 1);
+      files[nfiles].name = name;
+      files[nfiles].mtime = st.st_mtime;
+      nfiles++;
+    }
+  closedir (dir);
+
+  if (nfiles > ltrans_cache_size)
+    {
+      qsort (files, nfiles, sizeof (*files), ltrans_cache_file_cmp);
+      for (i = 0; i < nfiles - ltrans_cache_size; i++)
+	{
+	  if (verbose)
+	    fprintf (stderr, "[Removing LTRANS cache entry %s]\n",
+		     files[i].name);
+	  unlink (files[i].name);
 	}
     }
+  for (i = 0; i < nfiles; i++)
+    free (files[i].name);
+  free (files);
 }
 
 /* Find the crtoffloadtable.o file in LIBRARY_PATH, make copy and pass name of
@@ -1064,6 +1254,14 @@ run_gcc (unsigned argc, char *argv[])
 	    no_partition = true;
 	  break;
 
+	case OPT_flto_incremental_:
+	  ltrans_cache_dir = option->arg;
+	  break;
+
+	case OPT_flto_incremental_cache_size_:
+	  ltrans_cache_size = option->value;
+	  break;
+
 	case OPT_flto_:
 	  if (strcmp (option->arg, "jobserver") == 0)
 	    {
@@ -1094,6 +1292,15 @@ run_gcc (unsigned argc, char *argv[])
       parallel = 0;
     }
 
+  if (ltrans_cache_dir
+      && mkdir (ltrans_cache_dir, 0777) != 0
+      && errno != EEXIST)
+    {
+      warning (0, "cannot create LTRANS cache directory %s: %m",
+	       ltrans_cache_dir);
+      ltrans_cache_dir = NULL;
+    }
+
   if (linker_output)
     {
       char *output_dir, *base, *name;
@@ -1274,6 +1481,12 @@ cont1:
 	}
       else
         obstack_ptr_grow (&argv_obstack, "-fwpa");
+
+      /* WPA makes the section names in the LTRANS units unique with the
+	 random seed.  Fix it, so that an unchanged partition is streamed
+	 to the same bytes on every link and is found in the cache.  */
+      if (ltrans_cache_dir)
+	obstack_ptr_grow (&argv_obstack, "-frandom-seed=0");
     }
 
   /* Append the input objects and possible preceding arguments.  */
@@ -1296,6 +1509,7 @@ cont1:
       FILE *stream = fopen (ltrans_output_file, "r");
       FILE *mstream = NULL;
       struct obstack env_obstack;
+      char **cache_entries = NULL;
 
       if (!stream)
 	fatal_error (input_location, "fopen: %s: %m", ltrans_output_file);
@@ -1341,6 +1555,8 @@ cont:
 	  makefile = make_temp_file (".mk");
 	  mstream = fopen (makefile, "w");
 	}
+      if (ltrans_cache_dir)
+	cache_entries = XCNEWVEC (char *, nr);
 
       /* Execute the LTRANS stage for each input file (or prepare a
 	 makefile to invoke this in parallel).  */
@@ -1358,6 +1574,28 @@ cont:
 	  obstack_grow (&env_obstack, ".ltrans.o", sizeof (".ltrans.o"));
 	  output_name = XOBFINISH (&env_obstack, char *);
 
+	  /* Reuse the LTRANS object file of a previous link if this
+	     LTRANS unit has not changed since.  */
+	  if (cache_entries)
+	    {
+	      char *entry = ltrans_cache_entry (new_head_argc - 1, new_argv + 1,
+						input_name);
+	      if (access (entry, R_OK) == 0
+		  && copy_file (output_name, entry, /*fatal=*/false))
+		{
+		  if (verbose)
+		    fprintf (stderr, "[Reusing cached LTRANS %s]\n", entry);
+		  /* Mark the entry as recently used for ltrans_cache_trim.  */
+		  utime (entry, NULL);
+		  if (!parallel)
+		    maybe_unlink (input_name);
+		  output_names[i] = output_name;
+		  free (entry);
+		  continue;
+		}
+	      cache_entries[i] = entry;
+	    }
+
 	  /* Adjust the dumpbase if the linker output file was seen.  */
 	  if (linker_output)
 	    {
@@ -1394,6 +1632,8 @@ cont:
 	      fork_execute (new_argv[0], CONST_CAST (char **, new_argv),
 			    true);
 	      maybe_unlink (input_name);
+	      if (cache_entries)
+		ltrans_cache_store (cache_entries[i], output_name);
 	    }
 
 	  output_names[i] = output_name;
@@ -1435,13 +1675,22 @@ cont:
 	  makefile = NULL;
 	  for (i = 0; i < nr; ++i)
 	    maybe_unlink (input_names[i]);
+	  if (cache_entries)
+	    for (i = 0; i < nr; ++i)
+	      if (cache_entries[i])
+		ltrans_cache_store (cache_entries[i], output_names[i]);
 	}
+      if (cache_entries)
+	ltrans_cache_trim ();
       for (i = 0; i < nr; ++i)
 	{
 	  fputs (output_names[i], stdout);
 	  putc ('\n', stdout);
 	  free (input_names[i]);
+	  if (cache_entries)
+	    free (cache_entries[i]);
 	}
+      free (cache_entries);
       nr = 0;
       free (output_names);
       free (input_names);
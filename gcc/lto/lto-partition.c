@@ -50,6 +50,7 @@ new_partition (const char *name)
   part->encoder = lto_symtab_encoder_new (false);
   part->name = name;
   part->insns = 0;
+  part->weight = 0;
   part->symbols = 0;
   ltrans_partitions.safe_push (part);
   return part;
@@ -107,6 +108,33 @@ add_references_to_partition (ltrans_partition part, symtab_node *node)
       }
 }
 
+/* Return the estimated cost of compiling NODE, including the bodies inlined
+   into it, at LTRANS time.  Partitions are balanced by the sum of these
+   weights rather than by their size alone, since their size says nothing
+   about the time spent in the loop optimizers and the vectorizer.  The
+   estimated time of a function weights each statement by how often it is
+   executed, so the ratio of time to size grows with the depth of its loop
+   nests, and functions with a high ratio are given a larger weight.  */
+
+static int
+lto_node_weight (cgraph_node *node)
+{
+  struct inline_summary *info = inline_summaries->get (node);
+  int size = info->size;
+  int loop_depth;
+
+  if (size <= 0 || info->time <= size)
+    return MAX (size, 0);
+
+  /* With a guessed profile, the statements of each loop level are about
+     eight times as frequent as those of the level enclosing it.  */
+  loop_depth = MIN (floor_log2 (info->time / size) / 3, 3);
+  if (opt_for_fn (node->decl, flag_tree_loop_vectorize))
+    loop_depth *= 2;
+
+  return size + size / 2 * loop_depth;
+}
+
 /* Helper function for add_symbol_to_partition doing the actual dirty work
    of adding NODE to PART.  */
 
@@ -153,7 +181,11 @@ add_symbol_to_partition_1 (ltrans_partition part, symtab_node *node)
     {
       struct cgraph_edge *e;
       if (!node->alias)
-        part->insns += inline_summaries->get (cnode)->self_size;
+	{
+	  part->insns += inline_summaries->get (cnode)->self_size;
+	  if (!cnode->global.inlined_to)
+	    part->weight += lto_node_weight (cnode);
+	}
 
       /* Add all inline clones and callees that are duplicated.  */
       for (e = cnode->callees; e; e = e->next_callee)
@@ -277,7 +309,11 @@ undo_partition (ltrans_partition partition, unsigned int n_nodes)
       partition->initializers_visited = NULL;
 
       if (!node->alias && (cnode = dyn_cast <cgraph_node *> (node)))
-        partition->insns -= inline_summaries->get (cnode)->self_size;
+	{
+	  partition->insns -= inline_summaries->get (cnode)->self_size;
+	  if (!cnode->global.inlined_to)
+	    partition->weight -= lto_node_weight (cnode);
+	}
       lto_symtab_encoder_delete_node (partition->encoder, node);
       node->aux = (void *)((size_t)node->aux - 1);
     }
@@ -417,7 +453,8 @@ add_sorted_nodes (vec<symtab_node *> &next_nodes, ltrans_partition partition)
    at the moment we use the topological order, which is a good approximation.
 
    The goal is to partition this linear order into intervals (partitions) so
-   that all the partitions have approximately the same size and the number of
+   that all the partitions have approximately the same weight, which estimates
+   the time needed to compile them (see lto_node_weight), and the number of
    callgraph or IPA reference edges crossing boundaries is minimal.
 
    This is a lot faster (O(n) in size of callgraph) than algorithms doing
@@ -425,9 +462,12 @@ add_sorted_nodes (vec<symtab_node *> &next_nodes, ltrans_partition partition)
    WHOPR is designed to make things go well across partitions, it leads
    to good results.
 
-   We compute the expected size of a partition as:
+   We compute the expected weight of a partition as:
 
-     max (total_size / lto_partitions, min_partition_size)
+     max (total_weight / lto_partitions, min_partition_weight)
+
+   where min_partition_weight is min_partition_size, which counts insns,
+   scaled by the ratio of the total weight to the total size of the unit.
 
    We use dynamic expected size of partition so small programs are partitioned
    into enough partitions to allow use of multiple CPUs, while large programs
@@ -440,10 +480,11 @@ add_sorted_nodes (vec<symtab_node *> &next_nodes, ltrans_partition partition)
    since too many types and declarations are read into memory.
 
    The function implements a simple greedy algorithm.  Nodes are being added
-   to the current partition until after 3/4 of the expected partition size is
-   reached.  Past this threshold, we keep track of boundary size (number of
+   to the current partition until after 3/4 of the expected partition weight
+   is reached.  Past this threshold, we keep track of boundary size (number of
    edges going to other partitions) and continue adding functions until after
-   the current partition has grown to twice the expected partition size.  Then
+   the current partition has grown to twice the expected partition weight, or
+   its size exceeds MAX_PARTITION_SIZE.  Then
    the process is undone to the point where the minimal ratio of boundary size
    and in-partition calls was reached.  */
 
@@ -457,8 +498,8 @@ lto_balanced_map (int n_lto_partitions, int max_partition_size)
   auto_vec<varpool_node *> varpool_order;
   int i;
   struct cgraph_node *node;
-  int original_total_size, total_size = 0, best_total_size = 0;
-  int partition_size;
+  HOST_WIDE_INT original_total_size, total_size = 0, best_total_size = 0;
+  HOST_WIDE_INT partition_size, min_partition_size, total_insns = 0;
   ltrans_partition partition;
   int last_visited_node = 0;
   varpool_node *vnode;
@@ -480,7 +521,10 @@ lto_balanced_map (int n_lto_partitions, int max_partition_size)
 	else
 	  order[n_nodes++] = node;
 	if (!node->alias)
-	  total_size += inline_summaries->get (node)->size;
+	  {
+	    total_size += lto_node_weight (node);
+	    total_insns += inline_summaries->get (node)->size;
+	  }
       }
 
   original_total_size = total_size;
@@ -515,13 +559,20 @@ lto_balanced_map (int n_lto_partitions, int max_partition_size)
   if (PARAM_VALUE (MIN_PARTITION_SIZE) > max_partition_size)
     fatal_error (input_location, "min partition size cannot be greater than max partition size");
 
+  /* Partitions are balanced by weight, while MIN_PARTITION_SIZE counts
+     insns, so scale it by the average weight of an insn.  */
+  min_partition_size = PARAM_VALUE (MIN_PARTITION_SIZE);
+  if (total_insns > 0)
+    min_partition_size = min_partition_size * total_size / total_insns;
+
   partition_size = total_size / n_lto_partitions;
-  if (partition_size < PARAM_VALUE (MIN_PARTITION_SIZE))
-    partition_size = PARAM_VALUE (MIN_PARTITION_SIZE);
+  if (partition_size < min_partition_size)
+    partition_size = min_partition_size;
   npartitions = 1;
   partition = new_partition ("");
   if (symtab->dump_file)
-    fprintf (symtab->dump_file, "Total unit size: %i, partition size: %i\n",
+    fprintf (symtab->dump_file, "Total unit weight: " HOST_WIDE_INT_PRINT_DEC
+	     ", partition weight: " HOST_WIDE_INT_PRINT_DEC "\n",
 	     total_size, partition_size);
 
   auto_vec<symtab_node *> next_nodes;
@@ -542,14 +593,14 @@ lto_balanced_map (int n_lto_partitions, int max_partition_size)
 	     && noreorder[noreorder_pos]->order < current_order)
 	{
 	  if (!noreorder[noreorder_pos]->alias)
-	    total_size -= inline_summaries->get (noreorder[noreorder_pos])->size;
+	    total_size -= lto_node_weight (noreorder[noreorder_pos]);
 	  next_nodes.safe_push (noreorder[noreorder_pos++]);
 	}
       add_sorted_nodes (next_nodes, partition);
 
       add_symbol_to_partition (partition, order[i]);
       if (!order[i]->alias)
-        total_size -= inline_summaries->get (order[i])->size;
+        total_size -= lto_node_weight (order[i]);
 	  
 
       /* Once we added a new node to the partition, we also want to add
@@ -702,12 +753,12 @@ lto_balanced_map (int n_lto_partitions, int max_partition_size)
 	}
 
       /* If the partition is large enough, start looking for smallest boundary cost.  */
-      if (partition->insns < partition_size * 3 / 4
+      if (partition->weight < partition_size * 3 / 4
 	  || best_cost == INT_MAX
 	  || ((!cost 
 	       || (best_internal * (HOST_WIDE_INT) cost
 		   > (internal * (HOST_WIDE_INT)best_cost)))
-  	      && partition->insns < partition_size * 5 / 4))
+  	      && partition->weight < partition_size * 5 / 4))
 	{
 	  best_cost = cost;
 	  best_internal = internal;
@@ -717,14 +768,14 @@ lto_balanced_map (int n_lto_partitions, int max_partition_size)
 	  best_varpool_pos = varpool_pos;
 	}
       if (symtab->dump_file)
-	fprintf (symtab->dump_file, "Step %i: added %s/%i, size %i, cost %i/%i "
-		 "best %i/%i, step %i\n", i,
+	fprintf (symtab->dump_file, "Step %i: added %s/%i, size %i, weight %i, "
+		 "cost %i/%i best %i/%i, step %i\n", i,
 		 order[i]->name (), order[i]->order,
-		 partition->insns, cost, internal,
+		 partition->insns, partition->weight, cost, internal,
 		 best_cost, best_internal, best_i);
       /* Partition is too large, unwind into step when best cost was reached and
 	 start new partition.  */
-      if (partition->insns > 2 * partition_size
+      if (partition->weight > 2 * partition_size
 	  || partition->insns > max_partition_size)
 	{
 	  if (best_i != i)
@@ -751,15 +802,15 @@ lto_balanced_map (int n_lto_partitions, int max_partition_size)
 	  best_n_nodes = 0;
 	  best_cost = INT_MAX;
 
-	  /* Since the size of partitions is just approximate, update the size after
-	     we finished current one.  */
+	  /* Since the weight of partitions is just approximate, update the
+	     expected weight after we finished current one.  */
 	  if (npartitions < n_lto_partitions)
 	    partition_size = total_size / (n_lto_partitions - npartitions);
 	  else
 	    partition_size = INT_MAX;
 
-	  if (partition_size < PARAM_VALUE (MIN_PARTITION_SIZE))
-	    partition_size = PARAM_VALUE (MIN_PARTITION_SIZE);
+	  if (partition_size < min_partition_size)
+	    partition_size = min_partition_size;
 	  npartitions ++;
 	}
     }
@@ -794,9 +845,9 @@ lto_balanced_map (int n_lto_partitions, int max_partition_size)
 	{
 	  ltrans_partition p = ltrans_partitions[i];
 	  fprintf (symtab->dump_file, "partition %d contains %d (%2.2f%%)"
-		   " symbols and %d (%2.2f%%) insns\n", i, p->symbols,
-		   100.0 * p->symbols / n_nodes, p->insns,
-		   100.0 * p->insns / original_total_size);
+		   " symbols and %d insns, weight %d (%2.2f%%)\n", i,
+		   p->symbols, 100.0 * p->symbols / n_nodes, p->insns,
+		   p->weight, 100.0 * p->weight / original_total_size);
 	}
 
       fprintf (symtab->dump_file, "\n");
@@ -25,6 +25,7 @@ struct ltrans_partition_def
   lto_symtab_encoder_t encoder;
   const char * name;
   int insns;
+  int weight;
   int symbols;
   hash_set<symtab_node *> *initializers_visited;
 };
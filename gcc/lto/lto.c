@@ -2244,7 +2244,7 @@ free_section_data (struct lto_file_decl_data *file_data ATTRIBUTE_UNUSED,
 
 static lto_file *current_lto_file;
 
-/* Helper for qsort; compare partitions and return one with smaller size.
+/* Helper for qsort; compare partitions and return one with smaller weight.
    We sort from greatest to smallest so parallel build doesn't stale on the
    longest compilation being executed too late.  */
 
@@ -2255,7 +2255,7 @@ cmp_partitions_size (const void *a, const void *b)
      = *(struct ltrans_partition_def *const *)a;
   const struct ltrans_partition_def *pb
      = *(struct ltrans_partition_def *const *)b;
-  return pb->insns - pa->insns;
+  return pb->weight - pa->weight;
 }
 
 /* Helper for qsort; compare partitions and return one with smaller order.  */
@@ -2435,8 +2435,9 @@ lto_wpa_write_files (void)
 	{
           lto_symtab_encoder_iterator lsei;
 	  
-	  fprintf (symtab->dump_file, "Writing partition %s to file %s, %i insns\n",
-		   part->name, temp_filename, part->insns);
+	  fprintf (symtab->dump_file,
+		   "Writing partition %s to file %s, %i insns, weight %i\n",
+		   part->name, temp_filename, part->insns, part->weight);
 	  fprintf (symtab->dump_file, "  Symbols in partition: ");
 	  for (lsei = lsei_start_in_partition (part->encoder); !lsei_end_p (lsei);
 	       lsei_next_in_partition (&lsei))
@@ -2710,6 +2711,37 @@ static GTY((length ("real_file_count + 1"))) struct lto_file_decl_data **real_fi
 
 static void print_lto_report_1 (void);
 
+/* Ask the operating system to start reading the object file FNAME into
+   memory.  The input files are read and merged one after another, so
+   announcing the next file while the current one is being merged lets
+   the I/O for it overlap with the tree merging.  */
+
+static void
+lto_prefetch_file (const char *fname ATTRIBUTE_UNUSED)
+{
+#if defined (HAVE_POSIX_FADVISE) && defined (POSIX_FADV_WILLNEED)
+  const char *p;
+  long loffset;
+  int consumed;
+  int fd;
+
+  /* Archive members are named FILE@OFFSET.  The size of the member is
+     not known without parsing the archive, so leave those alone rather
+     than reading the whole archive.  */
+  if ((p = strrchr (fname, '@'))
+      && p != fname
+      && sscanf (p, "@%li%n", &loffset, &consumed) >= 1
+      && strlen (p) == (unsigned int) consumed)
+    return;
+
+  fd = open (fname, O_RDONLY | O_BINARY);
+  if (fd == -1)
+    return;
+  posix_fadvise (fd, 0, 0, POSIX_FADV_WILLNEED);
+  close (fd);
+#endif
+}
+
 /* Read all the symbols from the input files FNAMES.  NFILES is the
    number of files requested in the command line.  Instantiate a
    global call graph by aggregating all the sub-graphs found in each
@@ -2794,6 +2826,9 @@ read_cgraph_and_symbols (unsigned nfiles, const char **fnames)
 	  fflush (stderr);
 	}
 
+      if (i + 1 < nfiles)
+	lto_prefetch_file (fnames[i + 1]);
+
       current_lto_file = lto_obj_file_open (fnames[i], false);
       if (!current_lto_file)
 	break;
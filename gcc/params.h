@@ -202,6 +202,8 @@ extern void init_param_values (int *params);
   PARAM_VALUE (PARAM_IRA_MAX_LOOPS_NUM)
 #define IRA_MAX_CONFLICT_TABLE_SIZE \
   PARAM_VALUE (PARAM_IRA_MAX_CONFLICT_TABLE_SIZE)
+#define IRA_MAX_DENSE_CONFLICT_ALLOCNOS \
+  PARAM_VALUE (PARAM_IRA_MAX_DENSE_CONFLICT_ALLOCNOS)
 #define IRA_LOOP_RESERVED_REGS \
   PARAM_VALUE (PARAM_IRA_LOOP_RESERVED_REGS)
 #define LRA_MAX_CONSIDERED_RELOAD_PSEUDOS \
@@ -2453,6 +2453,7 @@ execute_one_pass (opt_pass *pass)
   /* If a timevar is present, start it.  */
   if (pass->tv_id != TV_NONE)
     timevar_push (pass->tv_id);
+  time_trace_span span (pass->name);
 
   /* Run pre-pass verification.  */
   execute_todo (pass->todo_flags_start);
@@ -2467,6 +2468,8 @@ execute_one_pass (opt_pass *pass)
   if (todo_after & TODO_discard_function)
     {
       /* Stop timevar.  */
+      if (span.wanted_p ())
+	span.finish (function_name (cfun));
       if (pass->tv_id != TV_NONE)
 	timevar_pop (pass->tv_id);
 
@@ -2509,6 +2512,8 @@ execute_one_pass (opt_pass *pass)
   verify_interpass_invariants ();
 
   /* Stop timevar.  */
+  if (span.wanted_p ())
+    span.finish (cfun ? function_name (cfun) : NULL);
   if (pass->tv_id != TV_NONE)
     timevar_pop (pass->tv_id);
 
@@ -2558,6 +2563,21 @@ execute_pass_list_1 (opt_pass *pass)
   while (pass);
 }
 
+/* Execute the pass list starting at PASS on function FN, which must
+   be the current function.
+
+   Note that functions are pushed through the whole pipeline one at a
+   time, and nothing here may run concurrently for two functions: the
+   passes communicate through per-function globals (cfun,
+   current_function_decl, crtl aka x_rtl, this_fn_optabs, the dump
+   file state and current_pass), they all allocate from the single
+   GC heap in ggc-page.c and from the shared default bitmap obstack,
+   and ggc_collect is invoked between passes.  Running the local
+   passes of independent cgraph nodes in parallel requires all of
+   those to become per-thread state first; until then, -flto=N with
+   -flto-partition is the way to spread one translation unit over
+   several cores.  */
+
 void
 execute_pass_list (function *fn, opt_pass *pass)
 {
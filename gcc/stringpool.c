@@ -248,6 +248,7 @@ struct GTY(()) string_pool_data {
 	 nested_ptr (union tree_node, "%h ? GCC_IDENT_TO_HT_IDENT (%h) : NULL",
 		     "%h ? HT_IDENT_TO_GCC_IDENT (%h) : NULL")))
     entries;
+  unsigned int * GTY((atomic)) hashes;
   unsigned int nslots;
   unsigned int nelements;
 };
@@ -263,8 +264,12 @@ gt_pch_save_stringpool (void)
   spd->nslots = ident_hash->nslots;
   spd->nelements = ident_hash->nelements;
   spd->entries = ggc_vec_alloc<ht_identifier_ptr> (spd->nslots);
-  memcpy (spd->entries, ident_hash->entries,
-	  spd->nslots * sizeof (spd->entries[0]));
+  spd->hashes = ggc_vec_alloc<unsigned int> (spd->nslots);
+  for (unsigned int i = 0; i < spd->nslots; i++)
+    {
+      spd->entries[i] = ident_hash->entries[i].node;
+      spd->hashes[i] = ident_hash->entries[i].hash;
+    }
 }
 
 /* Return the stringpool to its state before gt_pch_save_stringpool
@@ -281,7 +286,8 @@ gt_pch_fixup_stringpool (void)
 void
 gt_pch_restore_stringpool (void)
 {
-  ht_load (ident_hash, spd->entries, spd->nslots, spd->nelements, false);
+  ht_load (ident_hash, spd->entries, spd->hashes, spd->nslots,
+	   spd->nelements);
   spd = NULL;
 }
 
@@ -0,0 +1,23 @@
+/* Test that a header without include guard is preprocessed the same way
+   every time it is included.  */
+
+/* { dg-do compile } */
+
+#define ITEM(x) int x##1;
+#include "include8.h"
+#undef ITEM
+#define ITEM(x) int x##2;
+#include "include8.h"
+#undef ITEM
+#define ITEM(x) int x##3;
+#include "include8.h"
+#undef ITEM
+
+int
+sum (void)
+{
+#define ITEM(x) + x##1 + x##2 + x##3
+  return 0
+#include "include8.h"
+    ;
+}
@@ -0,0 +1,5 @@
+/* Included repeatedly by include8.c.  The line has to be spliced again
+   every time the file is included.  */
+ITEM (fir\
+st)
+ITEM (second)
@@ -0,0 +1,58 @@
+/* Check that register allocation with the compressed conflict table
+   gives correct code, including for the allocnos of inner regions.  */
+
+/* { dg-do run } */
+/* { dg-options "-O2 -fira-region=all --param ira-max-dense-conflict-allocnos=0 -fdump-rtl-ira -fira-verbose=1" } */
+
+extern void abort (void);
+
+int __attribute__ ((noinline, noclone))
+f (int *p, int n)
+{
+  int a = p[0], b = p[1], c = p[2], d = p[3];
+  int e = p[4], g = p[5], h = p[6], k = p[7];
+  int i, s = 0;
+
+  for (i = 0; i < n; i++)
+    {
+      int t = p[i] * a + b;
+      int u = t ^ c;
+      s += u + d;
+      if (s & 1)
+	{
+	  int v = s * e - g;
+	  s -= v >> 3;
+	}
+      else
+	s += h * k;
+      a += i;
+    }
+  return s + a + b + c + d + e + g + h + k;
+}
+
+int
+main (void)
+{
+  int p[16] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+  int a = 1, i, s = 0;
+
+  for (i = 0; i < 16; i++)
+    {
+      int t = p[i] * a + 2;
+      int u = t ^ 3;
+      s += u + 4;
+      if (s & 1)
+	{
+	  int v = s * 5 - 6;
+	  s -= v >> 3;
+	}
+      else
+	s += 7 * 8;
+      a += i;
+    }
+  if (f (p, 16) != s + a + 2 + 3 + 4 + 5 + 6 + 7 + 8)
+    abort ();
+  return 0;
+}
+
+/* { dg-final { scan-rtl-dump "compressed conflict table" "ira" } } */
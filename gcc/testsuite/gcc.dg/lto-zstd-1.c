@@ -0,0 +1,10 @@
+/* Test that -flto-compression-algorithm=zstd falls back to zlib with a
+   warning when the compiler is built without zstd.  */
+/* { dg-do compile { target { lto && { ! lto_zstd } } } } */
+/* { dg-options "-flto -flto-compression-algorithm=zstd" } */
+/* { dg-warning "not supported by this compiler; using zlib" "" { target *-*-* } 0 } */
+
+void
+foo (void)
+{
+}
@@ -0,0 +1,9 @@
+int __attribute__ ((noinline))
+sum (const int *p, int n)
+{
+  int i, s = 0;
+
+  for (i = 0; i < n; i++)
+    s += p[i];
+  return s;
+}
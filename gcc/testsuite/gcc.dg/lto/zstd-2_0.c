@@ -0,0 +1,19 @@
+/* { dg-lto-do run } */
+/* { dg-require-effective-target lto_zstd } */
+/* { dg-lto-options {{-O2 -flto -flto-compression-algorithm=zstd} {-O2 -flto -flto-partition=1to1 -flto-compression-algorithm=zstd}} } */
+
+/* Test that IL compressed with zlib is still read when zstd is selected,
+   and that it can be mixed with IL compressed with zstd.  */
+
+extern void abort (void);
+extern int sum (const int *, int);
+
+static const int v[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+int
+main (void)
+{
+  if (sum (v, sizeof (v) / sizeof (v[0])) != 55)
+    abort ();
+  return 0;
+}
@@ -0,0 +1,31 @@
+/* Check that, when the variable tracking size limit is exceeded both with
+   and without -fvar-tracking-assignments, the variables that debug insns
+   bind to registers are still tracked within their basic block.  */
+/* { dg-do compile } */
+/* { dg-options "-O2 -g --param max-vartrack-size=1 -fdump-rtl-vartrack" } */
+
+int
+f (unsigned int c, const char **pp, const char *pend, char *t,
+   unsigned char *b)
+{
+  const char *p = *pp;
+  unsigned int e;
+  int r;
+
+  if (p == pend)
+    return 11;
+  (*pp)++;
+  r = c > 255 ? 11 : 0;
+  c = t ? t[(unsigned char) c] : c;
+  e = (t ? t[(unsigned char) *p] : *p) & 255;
+  for (; c <= e; ++c)
+    {
+      unsigned char x = t ? t[(unsigned char) c] : c;
+      b[x / 8] |= 1 << (x % 8);
+      r = 0;
+    }
+  return r;
+}
+
+/* { dg-final { scan-rtl-dump "var_location e \\(reg" "vartrack" } } */
+/* { dg-final { scan-rtl-dump "var_location x \\(reg" "vartrack" } } */
@@ -0,0 +1,37 @@
+/* Check that a call that clobbers the register a variable is bound to
+   ends its location when the variable tracking size limit is exceeded
+   both with and without -fvar-tracking-assignments.  */
+/* { dg-do compile { target i?86-*-* x86_64-*-* } } */
+/* { dg-options "-O2 -g --param max-vartrack-size=1 -fdump-rtl-vartrack" } */
+
+int g (int);
+int h (void);
+
+int
+f (unsigned int c, const char **pp, const char *pend, char *t,
+   unsigned char *b)
+{
+  const char *p = *pp;
+  unsigned int e;
+  int r, y;
+
+  if (p == pend)
+    return 11;
+  (*pp)++;
+  r = c > 255 ? 11 : 0;
+  c = t ? t[(unsigned char) c] : c;
+  e = (t ? t[(unsigned char) *p] : *p) & 255;
+  for (; c <= e; ++c)
+    {
+      unsigned char x = t ? t[(unsigned char) c] : c;
+      b[x / 8] |= 1 << (x % 8);
+      r = 0;
+    }
+  y = h ();
+  g (y);
+  g (0);
+  return r;
+}
+
+/* { dg-final { scan-rtl-dump "var_location y \\(reg" "vartrack" } } */
+/* { dg-final { scan-rtl-dump "var_location y \\(nil\\)" "vartrack" } } */
@@ -0,0 +1,7 @@
+extern int bar (int);
+
+int
+main (void)
+{
+  return bar (0);
+}
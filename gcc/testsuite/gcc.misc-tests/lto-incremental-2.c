@@ -0,0 +1,5 @@
+int __attribute__ ((noinline))
+bar (int x)
+{
+  return x;
+}
@@ -23,6 +23,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "coretypes.h"
 #include "timevar.h"
 #include "options.h"
+#include "diagnostic-core.h"
 
 #ifndef HAVE_CLOCK_T
 typedef int clock_t;
@@ -816,3 +817,163 @@ print_time (const char *str, long total)
 	   all_time == 0 ? 0
 	   : (long) (((100.0 * (double) total) / (double) all_time) + .5));
 }
+
+/* Support for -ftime-trace.  */
+
+bool time_trace_enabled;
+
+/* An event recorded for -ftime-trace.  Times are in microseconds.  */
+
+struct time_trace_event
+{
+  const char *name;
+  char *detail;
+  uint64_t start;
+  uint64_t end;
+};
+
+/* The events recorded so far, in the order in which they ended.  */
+
+static vec<time_trace_event> time_trace_events;
+
+/* The time at which time_trace_init was called.  */
+
+static uint64_t time_trace_start;
+
+/* Return the current wall-clock time in microseconds.  The time base
+   is undefined, but the result is never zero.  */
+
+uint64_t
+time_trace_now (void)
+{
+#ifdef HAVE_GETTIMEOFDAY
+  struct timeval tv;
+  gettimeofday (&tv, NULL);
+  return (uint64_t) tv.tv_sec * 1000000 + tv.tv_usec + 1;
+#else
+  struct timevar_time_def now;
+  get_time (&now);
+  return (uint64_t) ((now.wall ? now.wall : now.user) * 1e6) + 1;
+#endif
+}
+
+/* Return true if a span from START to END is long enough to be worth
+   recording.  */
+
+bool
+time_trace_wanted_p (uint64_t start, uint64_t end)
+{
+  return end - start >= (uint64_t) time_trace_granularity;
+}
+
+/* Record an event called NAME, with DETAIL if non-NULL, that lasted
+   from START to END.  NAME must outlive the compilation; DETAIL is
+   copied.  */
+
+void
+time_trace_add (const char *name, const char *detail,
+		uint64_t start, uint64_t end)
+{
+  time_trace_event ev;
+  ev.name = name;
+  ev.detail = detail ? xstrdup (detail) : NULL;
+  ev.start = start;
+  ev.end = end;
+  time_trace_events.safe_push (ev);
+}
+
+/* Start collecting events for -ftime-trace.  */
+
+void
+time_trace_init (void)
+{
+  time_trace_enabled = true;
+  time_trace_start = time_trace_now ();
+}
+
+/* Write STR to F as the contents of a JSON string.  */
+
+static void
+time_trace_print_string (FILE *f, const char *str)
+{
+  for (const unsigned char *p = (const unsigned char *) str; *p; p++)
+    switch (*p)
+      {
+      case '"':
+	fputs ("\\\"", f);
+	break;
+      case '\\':
+	fputs ("\\\\", f);
+	break;
+      case '\n':
+	fputs ("\\n", f);
+	break;
+      case '\t':
+	fputs ("\\t", f);
+	break;
+      default:
+	if (*p < 0x20)
+	  fprintf (f, "\\u%04x", *p);
+	else
+	  putc (*p, f);
+      }
+}
+
+/* Write out one event to F.  */
+
+static void
+time_trace_print_event (FILE *f, const char *name, const char *detail,
+			uint64_t start, uint64_t end)
+{
+  fprintf (f, "{\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":%" PRIu64
+	   ",\"dur\":%" PRIu64 ",\"name\":\"",
+	   start - time_trace_start, end - start);
+  time_trace_print_string (f, name);
+  fputs ("\"", f);
+  if (detail)
+    {
+      fputs (",\"args\":{\"detail\":\"", f);
+      time_trace_print_string (f, detail);
+      fputs ("\"}", f);
+    }
+  fputs ("},\n", f);
+}
+
+/* Stop collecting events for -ftime-trace and write them to the file
+   named by -ftime-trace=, together with an event for the whole
+   compilation.  */
+
+void
+time_trace_finish (void)
+{
+  if (!time_trace_enabled)
+    return;
+
+  uint64_t end = time_trace_now ();
+  time_trace_enabled = false;
+
+  unsigned i;
+  time_trace_event *ev;
+  FILE *f = fopen (time_trace_file, "w");
+  if (!f)
+    error_at (UNKNOWN_LOCATION, "could not open time trace file %qs: %m",
+	      time_trace_file);
+  else
+    {
+      fputs ("{\"traceEvents\":[\n", f);
+      FOR_EACH_VEC_ELT (time_trace_events, i, ev)
+	time_trace_print_event (f, ev->name, ev->detail, ev->start, ev->end);
+      time_trace_print_event (f, "Total", progname, time_trace_start, end);
+      fputs ("{\"ph\":\"M\",\"pid\":1,\"tid\":0,\"name\":\"process_name\","
+	     "\"args\":{\"name\":\"", f);
+      time_trace_print_string (f, progname);
+      fputs ("\"}}\n],\"displayTimeUnit\":\"ms\"}\n", f);
+      if (fclose (f))
+	error_at (UNKNOWN_LOCATION, "could not write time trace file %qs: %m",
+		  time_trace_file);
+    }
+
+  FOR_EACH_VEC_ELT (time_trace_events, i, ev)
+    free (ev->detail);
+  time_trace_events.release ();
+}
@@ -258,4 +258,74 @@ class auto_timevar
 
 extern void print_time (const char *, long);
 
+/* Support for -ftime-trace.  Each event is a span of wall-clock time
+   with a name, which should be a string constant so that events can be
+   grouped by it, and an optional detail string.  The events are
+   written out as Chrome trace-event JSON at the end of compilation;
+   spans shorter than -ftime-trace-granularity are dropped.  */
+
+/* True if -ftime-trace events are being collected.  */
+extern bool time_trace_enabled;
+
+extern void time_trace_init (void);
+extern void time_trace_finish (void);
+extern uint64_t time_trace_now (void);
+extern bool time_trace_wanted_p (uint64_t, uint64_t);
+extern void time_trace_add (const char *, const char *, uint64_t, uint64_t);
+
+/* A span that is recorded when it goes out of scope, provided that
+   it lasted long enough.  Callers that want to attach a detail string
+   that is expensive to compute should do so only if wanted_p returns
+   true, as in
+
+     time_trace_span span ("Name");
+     ...
+     if (span.wanted_p ())
+       span.finish (expensive_detail ());  */
+
+class time_trace_span
+{
+ public:
+  explicit time_trace_span (const char *name)
+    : m_name (time_trace_enabled ? name : NULL),
+      m_start (m_name ? time_trace_now () : 0),
+      m_end (0)
+  {
+  }
+
+  ~time_trace_span ()
+  {
+    if (wanted_p ())
+      finish (NULL);
+  }
+
+  /* Stop the clock, and return true if the span is to be recorded.  */
+  bool wanted_p ()
+  {
+    if (!m_name)
+      return false;
+    if (!m_end)
+      m_end = time_trace_now ();
+    if (time_trace_wanted_p (m_start, m_end))
+      return true;
+    m_name = NULL;
+    return false;
+  }
+
+  /* Record the span with DETAIL, which is copied.  */
+  void finish (const char *detail)
+  {
+    time_trace_add (m_name, detail, m_start, m_end);
+    m_name = NULL;
+  }
+
+ private:
+  // Private to disallow copies.
+  time_trace_span (const time_trace_span &);
+
+  const char *m_name;
+  uint64_t m_start;
+  uint64_t m_end;
+};
+
 #endif /* ! GCC_TIMEVAR_H */
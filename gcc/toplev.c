@@ -1350,6 +1350,15 @@ process_options (void)
   if (!DELAY_SLOTS && flag_delayed_branch)
     warning_at (UNKNOWN_LOCATION, 0,
 		"this target machine does not have delayed branches");
+#ifndef HAVE_ZSTD_H
+  if (flag_lto_compression_algorithm == LTO_COMPRESSION_ZSTD)
+    {
+      warning_at (UNKNOWN_LOCATION, 0,
+		  "%<-flto-compression-algorithm=zstd%> not supported by "
+		  "this compiler; using zlib");
+      flag_lto_compression_algorithm = LTO_COMPRESSION_ZLIB;
+    }
+#endif
 
   user_label_prefix = USER_LABEL_PREFIX;
   if (flag_leading_underscore != -1)
@@ -2131,7 +2140,10 @@ toplev::main (int argc, char **argv)
     {
       if (m_use_TV_TOTAL)
 	start_timevars ();
+      if (time_trace_file)
+	time_trace_init ();
       do_compile ();
+      time_trace_finish ();
     }
 
   if (warningcount || errorcount || werrorcount)
@@ -2650,6 +2650,10 @@ solve_graph (constraint_graph_t graph)
   bitmap pts;
 
   changed = BITMAP_ALLOC (NULL);
+  /* CHANGED is large and sparse and only ever queried one bit at a time
+     in topological rather than index order; a splay tree beats a
+     linked list walk there.  */
+  bitmap_tree_view (changed);
 
   /* Mark all initial non-collapsed nodes as changed.  */
   for (i = 1; i < size; i++)
@@ -10229,16 +10229,194 @@ delete_debug_insns (void)
     }
 }
 
+/* State of the basic block local variable tracking.  */
+
+struct vt_local_data
+{
+  /* The hard register each variable bound in the current basic block
+     is known to live in, or NULL_RTX if it no longer is.  */
+  hash_map<tree, rtx> *locs;
+
+  /* The variables in LOCS, in the order they were first bound.  */
+  auto_vec<tree> vars;
+
+  /* For each hard register, the variables bound to it in the current
+     basic block.  Some of them may have been bound elsewhere since.  */
+  auto_vec<tree> reg_vars[FIRST_PSEUDO_REGISTER];
+
+  /* The insn after which the notes for locations that end are
+     emitted, and whether they end during a call.  */
+  rtx_insn *insn;
+  bool during_call_p;
+};
+
+/* Emit after INSN a NOTE_INSN_VAR_LOCATION saying that DECL lives in
+   LOC, or that its location is unknown if LOC is NULL_RTX.  If
+   DURING_CALL_P, the note already applies during the call INSN.  */
+
+static void
+vt_local_emit_note (tree decl, rtx loc, rtx_insn *insn, bool during_call_p)
+{
+  rtx_note *note = emit_note_after (NOTE_INSN_VAR_LOCATION, insn);
+  NOTE_VAR_LOCATION (note)
+    = gen_rtx_VAR_LOCATION (VOIDmode, decl, loc,
+			    VAR_INIT_STATUS_INITIALIZED);
+  NOTE_DURING_CALL_P (note) = during_call_p;
+}
+
+/* End the locations of the variables that live in hard register
+   REGNO, which DATA->insn modifies.  */
+
+static void
+vt_local_end_reg (struct vt_local_data *data, unsigned int regno)
+{
+  unsigned int i;
+  tree decl;
+
+  FOR_EACH_VEC_ELT (data->reg_vars[regno], i, decl)
+    {
+      rtx *loc = data->locs->get (decl);
+
+      if (*loc && REGNO (*loc) <= regno && regno < END_REGNO (*loc))
+	{
+	  vt_local_emit_note (decl, NULL_RTX, data->insn,
+			      data->during_call_p);
+	  *loc = NULL_RTX;
+	}
+    }
+  data->reg_vars[regno].truncate (0);
+}
+
+/* Called via note_stores.  End the locations of the variables living
+   in the registers stored to by LOC.  */
+
+static void
+vt_local_note_store (rtx loc, const_rtx, void *data)
+{
+  unsigned int regno;
+
+  if (GET_CODE (loc) == SUBREG)
+    loc = SUBREG_REG (loc);
+  if (!REG_P (loc) || !HARD_REGISTER_P (loc))
+    return;
+  for (regno = REGNO (loc); regno < END_REGNO (loc); regno++)
+    vt_local_end_reg ((struct vt_local_data *) data, regno);
+}
+
+/* Turn the debug bind insns into NOTE_INSN_VAR_LOCATION notes for the
+   variables bound to hard registers, keeping each location until the
+   register is modified or the basic block ends.  This needs no
+   dataflow, so it takes time linear in the size of the function.  */
+
+static void
+vt_local_locations (void)
+{
+  struct vt_local_data data;
+  hash_map<tree, rtx> locs;
+  rtx_insn *insn;
+  unsigned int i, regno;
+  tree decl;
+
+  data.locs = &locs;
+  for (insn = get_insns (); insn; insn = NEXT_INSN (insn))
+    {
+      if (NOTE_INSN_BASIC_BLOCK_P (insn))
+	{
+	  /* Control can reach the block from elsewhere.  */
+	  FOR_EACH_VEC_ELT (data.vars, i, decl)
+	    if (*locs.get (decl))
+	      vt_local_emit_note (decl, NULL_RTX, insn, false);
+	  data.vars.truncate (0);
+	  locs.empty ();
+	  for (regno = 0; regno < FIRST_PSEUDO_REGISTER; regno++)
+	    data.reg_vars[regno].truncate (0);
+	}
+      else if (DEBUG_INSN_P (insn))
+	{
+	  rtx loc = INSN_VAR_LOCATION_LOC (insn);
+	  bool existed;
+
+	  decl = INSN_VAR_LOCATION_DECL (insn);
+	  if (TREE_CODE (decl) != VAR_DECL && TREE_CODE (decl) != PARM_DECL)
+	    continue;
+
+	  if (!REG_P (loc)
+	      || !HARD_REGISTER_P (loc)
+	      || GET_MODE (loc) != DECL_MODE (decl)
+	      || DECL_MODE (decl) == BLKmode)
+	    loc = NULL_RTX;
+
+	  rtx &cur = locs.get_or_insert (decl, &existed);
+	  if (!existed)
+	    {
+	      cur = NULL_RTX;
+	      data.vars.safe_push (decl);
+	    }
+	  if (loc ? cur && rtx_equal_p (cur, loc) : !cur)
+	    continue;
+
+	  vt_local_emit_note (decl, loc, insn, false);
+	  cur = loc;
+	  if (loc)
+	    for (regno = REGNO (loc); regno < END_REGNO (loc); regno++)
+	      data.reg_vars[regno].safe_push (decl);
+	}
+      else if (INSN_P (insn))
+	{
+	  rtx note;
+
+	  data.insn = insn;
+	  if (CALL_P (insn))
+	    {
+	      /* The registers clobbered by the call are unknown already
+		 in the callee.  */
+	      data.during_call_p = true;
+	      for (regno = 0; regno < FIRST_PSEUDO_REGISTER; regno++)
+		if (TEST_HARD_REG_BIT (regs_invalidated_by_call, regno))
+		  vt_local_end_reg (&data, regno);
+	      for (note = CALL_INSN_FUNCTION_USAGE (insn); note;
+		   note = XEXP (note, 1))
+		if (GET_CODE (XEXP (note, 0)) == CLOBBER)
+		  vt_local_note_store (XEXP (XEXP (note, 0), 0), NULL_RTX,
+				       &data);
+	    }
+
+	  data.during_call_p = false;
+	  note_stores (PATTERN (insn), vt_local_note_store, &data);
+	  for (note = REG_NOTES (insn); note; note = XEXP (note, 1))
+	    if (REG_NOTE_KIND (note) == REG_INC)
+	      vt_local_note_store (XEXP (note, 0), NULL_RTX, &data);
+	}
+    }
+}
+
+/* Remove the notes emitted by vt_local_locations, before the dataflow
+   analysis emits its own.  */
+
+static void
+vt_local_remove_notes (void)
+{
+  rtx_insn *insn, *next;
+
+  for (insn = get_insns (); insn; insn = next)
+    {
+      next = NEXT_INSN (insn);
+      if (NOTE_P (insn) && NOTE_KIND (insn) == NOTE_INSN_VAR_LOCATION)
+	delete_insn (insn);
+    }
+}
+
 /* Run a fast, BB-local only version of var tracking, to take care of
    information that we don't do global analysis on, such that not all
    information is lost.  If SKIPPED holds, we're skipping the global
-   pass entirely, so we should try to use information it would have
-   handled as well..  */
+   pass entirely, so we use the debug bind insns it would have
+   handled to track variables within basic blocks.  */
 
 static void
-vt_debug_insns_local (bool skipped ATTRIBUTE_UNUSED)
+vt_debug_insns_local (bool skipped)
 {
-  /* ??? Just skip it all for now.  */
+  if (skipped && MAY_HAVE_DEBUG_INSNS)
+    vt_local_locations ();
   delete_debug_insns ();
 }
 
@@ -10299,9 +10477,10 @@ vt_finalize (void)
 
 /* The entry point to variable tracking pass.  */
 
-static inline unsigned int
-variable_tracking_main_1 (void)
+unsigned int
+variable_tracking_main (void)
 {
+  int save = flag_var_tracking_assignments;
   bool success;
 
   if (flag_var_tracking_assignments < 0
@@ -10334,53 +10513,43 @@ variable_tracking_main_1 (void)
     {
       vt_finalize ();
 
+      /* Keep what the debug insns say within each basic block, in
+	 case the retry fails as well.  */
+      vt_local_locations ();
       delete_debug_insns ();
 
-      /* This is later restored by our caller.  */
+      /* This is restored below.  */
       flag_var_tracking_assignments = 0;
 
       success = vt_initialize ();
       gcc_assert (success);
 
       success = vt_find_locations ();
+      if (success)
+	vt_local_remove_notes ();
     }
 
-  if (!success)
+  if (success)
     {
-      vt_finalize ();
-      vt_debug_insns_local (false);
-      return 0;
-    }
+      if (dump_file && (dump_flags & TDF_DETAILS))
+	{
+	  dump_dataflow_sets ();
+	  dump_reg_info (dump_file);
+	  dump_flow_info (dump_file, dump_flags);
+	}
 
-  if (dump_file && (dump_flags & TDF_DETAILS))
-    {
-      dump_dataflow_sets ();
-      dump_reg_info (dump_file);
-      dump_flow_info (dump_file, dump_flags);
+      timevar_push (TV_VAR_TRACKING_EMIT);
+      vt_emit_notes ();
+      timevar_pop (TV_VAR_TRACKING_EMIT);
     }
 
-  timevar_push (TV_VAR_TRACKING_EMIT);
-  vt_emit_notes ();
-  timevar_pop (TV_VAR_TRACKING_EMIT);
-
   vt_finalize ();
   vt_debug_insns_local (false);
-  return 0;
-}
-
-unsigned int
-variable_tracking_main (void)
-{
-  unsigned int ret;
-  int save = flag_var_tracking_assignments;
-
-  ret = variable_tracking_main_1 ();
 
   flag_var_tracking_assignments = save;
-
-  return ret;
+  return 0;
 }
-
+
 namespace {
 
 const pass_data pass_data_variable_tracking =
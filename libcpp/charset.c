@@ -2006,6 +2006,54 @@ _cpp_interpret_identifier (cpp_reader *pfile, const uchar *id, size_t len)
 				  buf, bufp - buf, HT_ALLOC));
 }
 
+/* Return true if source files in INPUT_CHARSET need no conversion to the
+   source character set, so that _cpp_terminate_input may be used on them
+   instead of _cpp_convert_input.  */
+bool
+_cpp_source_charset_p (const char *input_charset)
+{
+  return !strcasecmp (SOURCE_CHARSET, input_charset);
+}
+
+/* Prepare the LEN bytes of source file contents at TEXT, which must be
+   followed by at least 16 writable bytes, for the lexer in place.  Return
+   the start of the meaningful data, which may differ from TEXT in the case
+   of a BOM, and set *ST_SIZE to its length.  */
+uchar *
+_cpp_terminate_input (uchar *text, size_t len, off_t *st_size)
+{
+  uchar *buffer;
+
+  memset (text + len, '\0', 16);
+
+  /* If the file is using old-school Mac line endings (\r only),
+     terminate with another \r, not an \n, so that we do not mistake
+     the \r\n sequence for a single DOS line ending and erroneously
+     issue the "No newline at end of file" diagnostic.  */
+  if (len && text[len - 1] == '\r')
+    text[len] = '\r';
+  else
+    text[len] = '\n';
+
+  buffer = text;
+  *st_size = len;
+#if HOST_CHARSET == HOST_CHARSET_ASCII
+  /* The HOST_CHARSET test just above ensures that the source charset
+     is UTF-8.  So, ignore a UTF-8 BOM if we see one.  Note that
+     glib'c UTF-8 iconv() provider (as of glibc 2.7) does not ignore a
+     BOM -- however, even if it did, we would still need this code due
+     to the 'convert_no_conversion' case.  */
+  if (len >= 3 && text[0] == 0xef && text[1] == 0xbb
+      && text[2] == 0xbf)
+    {
+      *st_size -= 3;
+      buffer += 3;
+    }
+#endif
+
+  return buffer;
+}
+
 /* Convert an input buffer (containing the complete contents of one
    source file) from INPUT_CHARSET to the source character set.  INPUT
    points to the input buffer, SIZE is its allocated size, and LEN is
@@ -2063,33 +2111,7 @@ _cpp_convert_input (cpp_reader *pfile, const char *input_charset,
   if (to.len + 4096 < to.asize || to.len + 16 > to.asize)
     to.text = XRESIZEVEC (uchar, to.text, to.len + 16);
 
-  memset (to.text + to.len, '\0', 16);
-
-  /* If the file is using old-school Mac line endings (\r only),
-     terminate with another \r, not an \n, so that we do not mistake
-     the \r\n sequence for a single DOS line ending and erroneously
-     issue the "No newline at end of file" diagnostic.  */
-  if (to.len && to.text[to.len - 1] == '\r')
-    to.text[to.len] = '\r';
-  else
-    to.text[to.len] = '\n';
-
-  buffer = to.text;
-  *st_size = to.len;
-#if HOST_CHARSET == HOST_CHARSET_ASCII
-  /* The HOST_CHARSET test just above ensures that the source charset
-     is UTF-8.  So, ignore a UTF-8 BOM if we see one.  Note that
-     glib'c UTF-8 iconv() provider (as of glibc 2.7) does not ignore a
-     BOM -- however, even if it did, we would still need this code due
-     to the 'convert_no_conversion' case.  */
-  if (to.len >= 3 && to.text[0] == 0xef && to.text[1] == 0xbb
-      && to.text[2] == 0xbf)
-    {
-      *st_size -= 3;
-      buffer += 3;
-    }
-#endif
-
+  buffer = _cpp_terminate_input (to.text, to.len, st_size);
   *buffer_start = to.text;
   return buffer;
 }
@@ -2648,6 +2648,7 @@ _cpp_pop_buffer (cpp_reader *pfile)
   struct _cpp_file *inc = buffer->file;
   struct if_stack *ifs;
   const unsigned char *to_free;
+  size_t to_free_mapped_size;
 
   /* Walk back up the conditional stack till we reach its level at
      entry to this file, issuing error messages.  */
@@ -2662,6 +2663,7 @@ _cpp_pop_buffer (cpp_reader *pfile)
   pfile->buffer = buffer->prev;
 
   to_free = buffer->to_free;
+  to_free_mapped_size = buffer->to_free_mapped_size;
   free (buffer->notes);
 
   /* Free the buffer object now; we may want to push a new buffer
@@ -2670,7 +2672,7 @@ _cpp_pop_buffer (cpp_reader *pfile)
 
   if (inc)
     {
-      _cpp_pop_file_buffer (pfile, inc, to_free);
+      _cpp_pop_file_buffer (pfile, inc, to_free, to_free_mapped_size);
 
       _cpp_do_file_change (pfile, LC_LEAVE, 0, 0, 0);
     }
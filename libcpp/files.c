@@ -48,6 +48,14 @@ along with this program; see the file COPYING3.  If not see
 #  define set_stdin_to_binary_mode() /* Nothing */
 #endif
 
+#ifdef HAVE_MMAP_FILE
+#include <sys/mman.h>
+/* Regular files of at least this many pages that need no charset
+   conversion are mapped into memory rather than read.  Reading smaller
+   files is cheaper than mapping them.  */
+# define MMAP_THRESHOLD 3
+#endif
+
 /* This structure represents a file searched for by CPP, whether it
    exists or not.  An instance may be pointed to by more than one
    cpp_file_hash_entry; at present no reference count is kept.  */
@@ -76,6 +84,14 @@ struct _cpp_file
      BUFFER; when freeing, this this pointer must be used instead.  */
   const uchar *buffer_start;
 
+  /* If nonzero, read_file() mapped the file into memory at BUFFER_START
+     and this is the size of the mapping.  */
+  size_t mapped_size;
+
+  /* A copy of the contents of NAME, kept once the file has been stacked
+     more than once so that read_file() need not read it again.  */
+  const uchar *saved_buffer;
+
   /* The macro, if any, preventing re-inclusion.  */
   const cpp_hashnode *cmacro;
 
@@ -660,6 +676,22 @@ _cpp_find_file (cpp_reader *pfile, const char *fname, cpp_dir *start_dir,
   return file;
 }
 
+/* Release the contents of a file starting at START, as allocated by
+   read_file_guts.  MAPPED_SIZE is the size of the mapping if the file was
+   mapped into memory, zero otherwise.  */
+static void
+free_file_contents (const uchar *start, size_t mapped_size)
+{
+#ifdef HAVE_MMAP_FILE
+  if (mapped_size)
+    {
+      munmap ((void *) start, mapped_size);
+      return;
+    }
+#endif
+  free ((void *) start);
+}
+
 /* Read a file into FILE->buffer, returning true on success.
 
    If FILE->fd is something weird, like a block device, we don't want
@@ -703,6 +735,43 @@ read_file_guts (cpp_reader *pfile, _cpp_file *file, source_location loc)
 	}
 
       size = file->st.st_size;
+
+#ifdef HAVE_MMAP_FILE
+      /* Map large files instead of reading them.  The pages stay shared
+	 with the page cache until the lexer writes to them, which it does
+	 only to splice lines or replace trigraphs.  The mapping provides
+	 the terminating newline and the padding after it only if they fit
+	 in the last page, which the system fills with zeros past the end
+	 of the file.
+
+	 Unlike a read, the mapping does not take a snapshot of the file:
+	 if another process truncates the file while it is being lexed,
+	 touching the pages past the new end raises SIGBUS and the compiler
+	 dies instead of reporting an error.  Concurrent modification of
+	 the file gives unspecified results with either method, but this
+	 failure is harsher, and it is the reason libcpp once stopped
+	 mapping files; it is accepted here for files large enough for the
+	 saved copy to matter.  */
+      size_t page_size = sysconf (_SC_PAGE_SIZE);
+      size_t tail = size % page_size;
+      if ((size_t) size >= MMAP_THRESHOLD * page_size
+	  && tail != 0 && tail <= page_size - 16
+	  && _cpp_source_charset_p (CPP_OPTION (pfile, input_charset)))
+	{
+	  void *map = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+			    file->fd, 0);
+	  if (map != MAP_FAILED)
+	    {
+	      buf = (uchar *) map;
+	      file->buffer = _cpp_terminate_input (buf, size,
+						   &file->st.st_size);
+	      file->buffer_start = buf;
+	      file->mapped_size = size;
+	      file->buffer_valid = true;
+	      return true;
+	    }
+	}
+#endif
     }
   else
     /* 8 kilobytes is a sensible starting size.  It ought to be bigger
@@ -745,6 +814,7 @@ read_file_guts (cpp_reader *pfile, _cpp_file *file, source_location loc)
 				     buf, size + 16, total,
 				     &file->buffer_start,
 				     &file->st.st_size);
+  file->mapped_size = 0;
   file->buffer_valid = true;
 
   return true;
@@ -761,6 +831,23 @@ read_file (cpp_reader *pfile, _cpp_file *file, source_location loc)
   if (file->buffer_valid)
     return true;
 
+  /* Reuse the copy kept from earlier inclusions of the file.  */
+  if (file->saved_buffer)
+    {
+      uchar *buf = XNEWVEC (uchar, file->st.st_size + 16);
+
+      memcpy (buf, file->saved_buffer, file->st.st_size + 16);
+      file->buffer = file->buffer_start = buf;
+      file->mapped_size = 0;
+      file->buffer_valid = true;
+      if (file->fd != -1)
+	{
+	  close (file->fd);
+	  file->fd = -1;
+	}
+      return true;
+    }
+
   /* If an earlier read failed for some reason don't try again.  */
   if (file->dont_read || file->err_no)
     return false;
@@ -912,6 +999,19 @@ _cpp_stack_file (cpp_reader *pfile, _cpp_file *file, bool import,
 	deps_add_dep (pfile->deps, file->path);
     }
 
+  /* A file that is stacked a second time has no effective include guard,
+     and is often meant to be included many times, like <stddef.h> or
+     files of X-macros.  Keep a copy of its contents for later inclusions,
+     since _cpp_clean_line modifies the buffer in place and the file would
+     otherwise have to be read and converted again every time.  */
+  if (file->stack_count == 1 && !file->saved_buffer)
+    {
+      uchar *copy = XNEWVEC (uchar, file->st.st_size + 16);
+
+      memcpy (copy, file->buffer, file->st.st_size + 16);
+      file->saved_buffer = copy;
+    }
+
   /* Clear buffer_valid since _cpp_clean_line messes it up.  */
   file->buffer_valid = false;
   file->stack_count++;
@@ -923,6 +1023,7 @@ _cpp_stack_file (cpp_reader *pfile, _cpp_file *file, bool import,
   buffer->file = file;
   buffer->sysp = sysp;
   buffer->to_free = file->buffer_start;
+  buffer->to_free_mapped_size = file->mapped_size;
 
   /* Initialize controlling macro state.  */
   pfile->mi_valid = true;
@@ -1130,7 +1231,8 @@ make_cpp_file (cpp_reader *pfile, cpp_dir *dir, const char *fname)
 static void
 destroy_cpp_file (_cpp_file *file)
 {
-  free ((void *) file->buffer_start);
+  free_file_contents (file->buffer_start, file->mapped_size);
+  free ((void *) file->saved_buffer);
   free ((void *) file->name);
   free ((void *) file->path);
   free (file);
@@ -1497,7 +1599,7 @@ cpp_push_default_include (cpp_reader *pfile, const char *fname)
    input stack.  */
 void
 _cpp_pop_file_buffer (cpp_reader *pfile, _cpp_file *file,
-		      const unsigned char *to_free)
+		      const unsigned char *to_free, size_t to_free_mapped_size)
 {
   /* Record the inclusion-preventing macro, which could be NULL
      meaning no controlling macro.  */
@@ -1513,9 +1615,10 @@ _cpp_pop_file_buffer (cpp_reader *pfile, _cpp_file *file,
 	{
 	  file->buffer_start = NULL;
 	  file->buffer = NULL;
+	  file->mapped_size = 0;
 	  file->buffer_valid = false;
 	}
-      free ((void *) to_free);
+      free_file_contents (to_free, to_free_mapped_size);
     }
 }
 
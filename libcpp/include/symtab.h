@@ -42,13 +42,21 @@ typedef struct ht_identifier *hashnode;
 
 enum ht_lookup_option {HT_NO_INSERT = 0, HT_ALLOC};
 
+/* A slot of the hash table.  The hash value of the node is kept next to
+   it, so that probing past other entries need not dereference them.  */
+struct ht_slot
+{
+  hashnode node;
+  unsigned int hash;
+};
+
 /* An identifier hash table for cpplib and the front ends.  */
 struct ht
 {
   /* Identifiers are allocated from here.  */
   struct obstack stack;
 
-  hashnode *entries;
+  struct ht_slot *entries;
   /* Call back, allocate a node.  */
   hashnode (*alloc_node) (cpp_hash_table *);
   /* Call back, allocate something that hangs off a node like a cpp_macro.  
@@ -64,9 +72,6 @@ struct ht
   /* Table usage statistics.  */
   unsigned int searches;
   unsigned int collisions;
-
-  /* Should 'entries' be freed when it is no longer needed?  */
-  bool entries_owned;
 };
 
 /* Initialize the hashtable with 2 ^ order entries.  */
@@ -80,8 +85,46 @@ extern hashnode ht_lookup (cpp_hash_table *, const unsigned char *,
 extern hashnode ht_lookup_with_hash (cpp_hash_table *, const unsigned char *,
                                      size_t, unsigned int,
                                      enum ht_lookup_option);
-#define HT_HASHSTEP(r, c) ((r) * 67 + ((c) - 113));
-#define HT_HASHFINISH(r, len) ((r) + (len))
+
+/* Return the hash value used for the LEN bytes at STR.  The bytes are
+   mixed into the hash a word at a time rather than one by one; the last
+   partial word is read overlapping the previous one, so that no loop
+   over single bytes is needed.  */
+inline unsigned int
+ht_calc_hash (const unsigned char *str, size_t len)
+{
+  const unsigned long long mul = 0x9e3779b97f4a7c15ULL;
+  unsigned long long h = len, w;
+  unsigned int lo, hi;
+
+  if (len > 8)
+    {
+      const unsigned char *last = str + len - 8;
+      for (; str < last; str += 8)
+	{
+	  memcpy (&w, str, 8);
+	  h = (h ^ w) * mul;
+	}
+      memcpy (&w, last, 8);
+    }
+  else if (len >= 4)
+    {
+      memcpy (&lo, str, 4);
+      memcpy (&hi, str + len - 4, 4);
+      w = ((unsigned long long) hi << 32) | lo;
+    }
+  else if (len)
+    w = str[0] | (str[len / 2] << 8) | (str[len - 1] << 16);
+  else
+    w = 0;
+  h = (h ^ w) * mul;
+
+  /* A multiplication only carries bits upwards; fold the high half back
+     in and take the top of the product, so that every byte of STR can
+     affect the low bits used to index the table.  */
+  h ^= h >> 32;
+  return (unsigned int) ((h * mul) >> 32);
+}
 
 /* For all nodes in TABLE, make a callback.  The callback takes
    TABLE->PFILE, the node, and a PTR, and the callback sequence stops
@@ -93,9 +136,10 @@ extern void ht_forall (cpp_hash_table *, ht_cb, const void *);
    a nonzero value, the node is removed from the table.  */
 extern void ht_purge (cpp_hash_table *, ht_cb, const void *);
 
-/* Restore the hash table.  */
+/* Restore the hash table from NSLOTS nodes and their hash values.  */
 extern void ht_load (cpp_hash_table *ht, hashnode *entries,
-		     unsigned int nslots, unsigned int nelements, bool own);
+		     unsigned int *hashes, unsigned int nslots,
+		     unsigned int nelements);
 
 /* Dump allocation statistics to stderr.  */
 extern void ht_dump_statistics (cpp_hash_table *);
@@ -310,6 +310,8 @@ struct cpp_buffer
   const unsigned char *rlimit;     /* Writable byte at end of file.  */
   const unsigned char *to_free;	   /* Pointer that should be freed when
 				      popping the buffer.  */
+  size_t to_free_mapped_size;	   /* If nonzero, TO_FREE is a mapped file
+				      of this size, to be unmapped.  */
 
   _cpp_line_note *notes;           /* Array of notes.  */
   unsigned int cur_note;           /* Next note to process.  */
@@ -658,7 +660,7 @@ extern void _cpp_report_missing_guards (cpp_reader *);
 extern void _cpp_init_files (cpp_reader *);
 extern void _cpp_cleanup_files (cpp_reader *);
 extern void _cpp_pop_file_buffer (cpp_reader *, struct _cpp_file *,
-				  const unsigned char *);
+				  const unsigned char *, size_t);
 extern bool _cpp_save_file_entries (cpp_reader *pfile, FILE *f);
 extern bool _cpp_read_file_entries (cpp_reader *, FILE *);
 extern const char *_cpp_get_file_name (_cpp_file *);
@@ -761,6 +763,8 @@ extern void _cpp_destroy_iconv (cpp_reader *);
 extern unsigned char *_cpp_convert_input (cpp_reader *, const char *,
 					  unsigned char *, size_t, size_t,
 					  const unsigned char **, off_t *);
+extern bool _cpp_source_charset_p (const char *);
+extern unsigned char *_cpp_terminate_input (unsigned char *, size_t, off_t *);
 extern const char *_cpp_default_encoding (void);
 extern cpp_hashnode * _cpp_interpret_identifier (cpp_reader *pfile,
 						 const unsigned char *id,
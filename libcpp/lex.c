@@ -275,17 +275,18 @@ search_line_acc_char (const uchar *s, const uchar *end ATTRIBUTE_UNUSED)
 /* Replicated character data to be shared between implementations.
    Recall that outside of a context with vector support we can't
    define compatible vector types, therefore these are all defined
-   in terms of raw characters.  */
-static const char repl_chars[4][16] __attribute__((aligned(16))) = {
-  { '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n',
-    '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n' },
-  { '\r', '\r', '\r', '\r', '\r', '\r', '\r', '\r',
-    '\r', '\r', '\r', '\r', '\r', '\r', '\r', '\r' },
-  { '\\', '\\', '\\', '\\', '\\', '\\', '\\', '\\',
-    '\\', '\\', '\\', '\\', '\\', '\\', '\\', '\\' },
-  { '?', '?', '?', '?', '?', '?', '?', '?',
-    '?', '?', '?', '?', '?', '?', '?', '?' },
+   in terms of raw characters.  The rows are as wide as the widest
+   vector used below; narrower scanners use a prefix of each row.  */
+#define REPL_16(C) C, C, C, C, C, C, C, C, C, C, C, C, C, C, C, C
+#define REPL_64(C) REPL_16 (C), REPL_16 (C), REPL_16 (C), REPL_16 (C)
+static const char repl_chars[4][64] __attribute__((aligned(64))) = {
+  { REPL_64 ('\n') },
+  { REPL_64 ('\r') },
+  { REPL_64 ('\\') },
+  { REPL_64 ('?') },
 };
+#undef REPL_64
+#undef REPL_16
 
 /* A version of the fast scanner using MMX vectorized byte compare insns.
 
@@ -487,6 +488,106 @@ search_line_sse42 (const uchar *s, const uchar *end)
 #define search_line_sse42 search_line_sse2
 #endif
 
+#if defined (HAVE_AVX2) && GCC_VERSION >= 4007
+/* A version of the fast scanner using AVX2 vectorized byte compare insns.
+   This is the SSE2 algorithm on 32-byte blocks.  */
+
+static const uchar *
+#ifndef __AVX2__
+__attribute__((__target__("avx2")))
+#endif
+search_line_avx2 (const uchar *s, const uchar *end ATTRIBUTE_UNUSED)
+{
+  typedef char v32qi __attribute__ ((__vector_size__ (32)));
+
+  const v32qi repl_nl = *(const v32qi *)repl_chars[0];
+  const v32qi repl_cr = *(const v32qi *)repl_chars[1];
+  const v32qi repl_bs = *(const v32qi *)repl_chars[2];
+  const v32qi repl_qm = *(const v32qi *)repl_chars[3];
+
+  unsigned int misalign, found, mask;
+  const v32qi *p;
+  v32qi data, t;
+
+  /* Align the source pointer, so that we never read beyond the end
+     of the page containing the terminating newline.  */
+  misalign = (uintptr_t)s & 31;
+  p = (const v32qi *)((uintptr_t)s & -32);
+  data = *p;
+
+  /* Mask out the bytes before S in the first block.  */
+  mask = -1u << misalign;
+
+  /* Main loop processing 32 bytes at a time.  */
+  goto start;
+  do
+    {
+      data = *++p;
+      mask = -1;
+
+    start:
+      t  = __builtin_ia32_pcmpeqb256 (data, repl_nl);
+      t |= __builtin_ia32_pcmpeqb256 (data, repl_cr);
+      t |= __builtin_ia32_pcmpeqb256 (data, repl_bs);
+      t |= __builtin_ia32_pcmpeqb256 (data, repl_qm);
+      found = __builtin_ia32_pmovmskb256 (t);
+      found &= mask;
+    }
+  while (!found);
+
+  found = __builtin_ctz (found);
+  return (const uchar *)p + found;
+}
+#endif
+
+#if defined (HAVE_AVX512BW) && GCC_VERSION >= 5000
+/* A version of the fast scanner using AVX-512BW byte compare insns, which
+   produce a bit mask directly, on 64-byte blocks.  */
+
+static const uchar *
+#ifndef __AVX512BW__
+__attribute__((__target__("avx512bw")))
+#endif
+search_line_avx512bw (const uchar *s, const uchar *end ATTRIBUTE_UNUSED)
+{
+  typedef char v64qi __attribute__ ((__vector_size__ (64)));
+
+  const v64qi repl_nl = *(const v64qi *)repl_chars[0];
+  const v64qi repl_cr = *(const v64qi *)repl_chars[1];
+  const v64qi repl_bs = *(const v64qi *)repl_chars[2];
+  const v64qi repl_qm = *(const v64qi *)repl_chars[3];
+
+  unsigned int misalign;
+  unsigned long long found, mask;
+  const v64qi *p;
+  v64qi data;
+
+  /* Align the source pointer, as for AVX2.  */
+  misalign = (uintptr_t)s & 63;
+  p = (const v64qi *)((uintptr_t)s & -64);
+  data = *p;
+  mask = -1ull << misalign;
+
+  /* Main loop processing 64 bytes at a time.  */
+  goto start;
+  do
+    {
+      data = *++p;
+      mask = -1;
+
+    start:
+      found  = __builtin_ia32_pcmpeqb512_mask (data, repl_nl, mask);
+      found |= __builtin_ia32_pcmpeqb512_mask (data, repl_cr, mask);
+      found |= __builtin_ia32_pcmpeqb512_mask (data, repl_bs, mask);
+      found |= __builtin_ia32_pcmpeqb512_mask (data, repl_qm, mask);
+    }
+  while (!found);
+
+  found = __builtin_ctzll (found);
+  return (const uchar *)p + found;
+}
+#endif
+
 /* Check the CPU capabilities.  */
 
 #include "../gcc/config/i386/cpuid.h"
@@ -528,6 +629,28 @@ init_vectorized_lexer (void)
 	impl = search_line_mmx;
     }
 
+#if defined (HAVE_AVX2) && GCC_VERSION >= 4007
+  /* The wider scanners also need the OS to preserve the upper parts
+     of the vector registers, as reported by XCR0.  */
+  if (__get_cpuid (1, &dummy, &dummy, &ecx, &edx)
+      && (ecx & bit_OSXSAVE))
+    {
+      unsigned ebx = 0, xcr0, xcr0_hi;
+
+      __get_cpuid_count (7, 0, &dummy, &ebx, &dummy, &dummy);
+      __asm__ ("xgetbv" : "=a" (xcr0), "=d" (xcr0_hi) : "c" (0));
+
+      /* XMM and YMM state.  */
+      if ((xcr0 & 0x6) == 0x6 && (ebx & bit_AVX2))
+	impl = search_line_avx2;
+#if defined (HAVE_AVX512BW) && GCC_VERSION >= 5000
+      /* Opmask, ZMM_Hi256 and Hi16_ZMM state.  */
+      if ((xcr0 & 0xe6) == 0xe6 && (ebx & bit_AVX512BW))
+	impl = search_line_avx512bw;
+#endif
+    }
+#endif
+
   search_line_fast = impl;
 }
 
@@ -1067,7 +1190,10 @@ _cpp_clean_line (cpp_reader *pfile)
     }
 
  done:
-  *d = '\n';
+  /* Do not write the newline if it is already there, so that the pages
+     of a file mapped into memory stay shared with the page cache.  */
+  if (*d != '\n')
+    *d = '\n';
   /* A sentinel note that should never be processed.  */
   add_line_note (buffer, d + 1, '\n');
   buffer->next_line = s + 1;
@@ -1359,18 +1485,14 @@ lex_identifier_intern (cpp_reader *pfile, const uchar *base)
   cpp_hashnode *result;
   const uchar *cur;
   unsigned int len;
-  unsigned int hash = HT_HASHSTEP (0, *base);
 
   cur = base + 1;
   while (ISIDNUM (*cur))
-    {
-      hash = HT_HASHSTEP (hash, *cur);
-      cur++;
-    }
+    cur++;
   len = cur - base;
-  hash = HT_HASHFINISH (hash, len);
-  result = CPP_HASHNODE (ht_lookup_with_hash (pfile->hash_table,
-					      base, len, hash, HT_ALLOC));
+  result = CPP_HASHNODE (ht_lookup_with_hash (pfile->hash_table, base, len,
+					      ht_calc_hash (base, len),
+					      HT_ALLOC));
 
   /* Rarely, identifiers require diagnostics when lexed.  */
   if (__builtin_expect ((result->flags & NODE_DIAGNOSTIC)
@@ -1424,16 +1546,12 @@ lex_identifier (cpp_reader *pfile, const uchar *base, bool starts_ucn,
   cpp_hashnode *result;
   const uchar *cur;
   unsigned int len;
-  unsigned int hash = HT_HASHSTEP (0, *base);
 
   cur = pfile->buffer->cur;
   if (! starts_ucn)
     {
       while (ISIDNUM (*cur))
-	{
-	  hash = HT_HASHSTEP (hash, *cur);
-	  cur++;
-	}
+	cur++;
       NORMALIZE_STATE_UPDATE_IDNUM (nst, *(cur - 1));
     }
   pfile->buffer->cur = cur;
@@ -1454,10 +1572,10 @@ lex_identifier (cpp_reader *pfile, const uchar *base, bool starts_ucn,
   else
     {
       len = cur - base;
-      hash = HT_HASHFINISH (hash, len);
-
       result = CPP_HASHNODE (ht_lookup_with_hash (pfile->hash_table,
-						  base, len, hash, HT_ALLOC));
+						  base, len,
+						  ht_calc_hash (base, len),
+						  HT_ALLOC));
       *spelling = result;
     }
 
@@ -1585,17 +1703,14 @@ is_macro(cpp_reader *pfile, const uchar *base)
   const uchar *cur = base;
   if (! ISIDST (*cur))
     return false;
-  unsigned int hash = HT_HASHSTEP (0, *cur);
   ++cur;
   while (ISIDNUM (*cur))
-    {
-      hash = HT_HASHSTEP (hash, *cur);
-      ++cur;
-    }
-  hash = HT_HASHFINISH (hash, cur - base);
+    ++cur;
+  unsigned int len = cur - base;
 
   cpp_hashnode *result = CPP_HASHNODE (ht_lookup_with_hash (pfile->hash_table,
-					base, cur - base, hash, HT_NO_INSERT));
+					base, len, ht_calc_hash (base, len),
+					HT_NO_INSERT));
 
   return !result ? false : (result->type == NT_MACRO);
 }
@@ -104,6 +104,7 @@ static _cpp_buff *collect_args (cpp_reader *, const cpp_hashnode *,
 				_cpp_buff **, unsigned *);
 static cpp_context *next_context (cpp_reader *);
 static const cpp_token *padding_token (cpp_reader *, const cpp_token *);
+static bool arg_expansion_p (const macro_arg *);
 static void expand_arg (cpp_reader *, macro_arg *);
 static const cpp_token *new_string_token (cpp_reader *, uchar *, unsigned int);
 static const cpp_token *stringify_arg (cpp_reader *, macro_arg *);
@@ -1291,21 +1292,25 @@ delete_macro_args (_cpp_buff *buff, unsigned num_args)
      as their macro_arg::virt_locs members.  */
   for (i = 0; i < num_args; ++i)
     {
+      /* The expansion may share the tokens of the argument itself; see
+	 expand_arg.  */
       if (macro_args[i].expanded)
 	{
-	  free (macro_args[i].expanded);
+	  if (macro_args[i].expanded != macro_args[i].first)
+	    free (macro_args[i].expanded);
 	  macro_args[i].expanded = NULL;
 	}
+      if (macro_args[i].expanded_virt_locs)
+	{
+	  if (macro_args[i].expanded_virt_locs != macro_args[i].virt_locs)
+	    free (macro_args[i].expanded_virt_locs);
+	  macro_args[i].expanded_virt_locs = NULL;
+	}
       if (macro_args[i].virt_locs)
 	{
 	  free (macro_args[i].virt_locs);
 	  macro_args[i].virt_locs = NULL;
 	}
-      if (macro_args[i].expanded_virt_locs)
-	{
-	  free (macro_args[i].expanded_virt_locs);
-	  macro_args[i].expanded_virt_locs = NULL;
-	}
     }
   _cpp_free_buff (buff);
 }
@@ -2199,6 +2204,30 @@ ensure_expanded_arg_room (cpp_reader *pfile, macro_arg *arg,
     }
 }
 
+/* Return true if macro-expanding the tokens of the argument ARG might
+   yield anything other than those same tokens, that is if one of them
+   names a macro that could be expanded or is the left operand of a
+   paste.  */
+static bool
+arg_expansion_p (const macro_arg *arg)
+{
+  unsigned int i;
+
+  for (i = 0; i < arg->count; i++)
+    {
+      const cpp_token *token = arg->first[i];
+
+      if (token->flags & PASTE_LEFT)
+	return true;
+      if (token->type == CPP_NAME
+	  && token->val.node.node->type == NT_MACRO
+	  && !(token->flags & NO_EXPAND))
+	return true;
+    }
+
+  return false;
+}
+
 /* Expand an argument ARG before replacing parameters in a
    function-like macro.  This works by pushing a context with the
    argument's tokens, and then expanding that into a temporary buffer
@@ -2216,6 +2245,17 @@ expand_arg (cpp_reader *pfile, macro_arg *arg)
       || arg->expanded != NULL)
     return;
 
+  /* Most arguments contain no macros at all.  Their expansion is the
+     argument itself, so share its tokens and virtual locations rather
+     than pushing them through cpp_get_token_1 into a new buffer.  */
+  if (!arg_expansion_p (arg))
+    {
+      arg->expanded = arg->first;
+      arg->expanded_virt_locs = arg->virt_locs;
+      arg->expanded_count = arg->count;
+      return;
+    }
+
   /* Don't warn about funlike macros when pre-expanding.  */
   saved_warn_trad = CPP_WTRADITIONAL (pfile);
   CPP_WTRADITIONAL (pfile) = 0;
@@ -29,27 +29,12 @@ along with this program; see the file COPYING3.  If not see
    intrinsically how to calculate a hash value, and how to compare an
    existing entry with a potential new one.  */
 
-static unsigned int calc_hash (const unsigned char *, size_t);
 static void ht_expand (cpp_hash_table *);
 static double approx_sqrt (double);
 
 /* A deleted entry.  */
 #define DELETED ((hashnode) -1)
 
-/* Calculate the hash of the string STR of length LEN.  */
-
-static unsigned int
-calc_hash (const unsigned char *str, size_t len)
-{
-  size_t n = len;
-  unsigned int r = 0;
-
-  while (n--)
-    r = HT_HASHSTEP (r, *str++);
-
-  return HT_HASHFINISH (r, len);
-}
-
 /* Initialize an identifier hashtable.  */
 
 cpp_hash_table *
@@ -65,8 +50,7 @@ ht_create (unsigned int order)
 
   obstack_alignment_mask (&table->stack) = 0;
 
-  table->entries = XCNEWVEC (hashnode, nslots);
-  table->entries_owned = true;
+  table->entries = XCNEWVEC (struct ht_slot, nslots);
   table->nslots = nslots;
   return table;
 }
@@ -77,8 +61,7 @@ void
 ht_destroy (cpp_hash_table *table)
 {
   obstack_free (&table->stack, NULL);
-  if (table->entries_owned)
-    free (table->entries);
+  free (table->entries);
   free (table);
 }
 
@@ -91,7 +74,7 @@ hashnode
 ht_lookup (cpp_hash_table *table, const unsigned char *str, size_t len,
 	   enum ht_lookup_option insert)
 {
-  return ht_lookup_with_hash (table, str, len, calc_hash (str, len),
+  return ht_lookup_with_hash (table, str, len, ht_calc_hash (str, len),
 			      insert);
 }
 
@@ -110,13 +93,13 @@ ht_lookup_with_hash (cpp_hash_table *table, const unsigned char *str,
   index = hash & sizemask;
   table->searches++;
 
-  node = table->entries[index];
+  node = table->entries[index].node;
 
   if (node != NULL)
     {
       if (node == DELETED)
 	deleted_index = index;
-      else if (node->hash_value == hash
+      else if (table->entries[index].hash == hash
 	       && HT_LEN (node) == (unsigned int) len
 	       && !memcmp (HT_STR (node), str, len))
 	return node;
@@ -129,7 +112,7 @@ ht_lookup_with_hash (cpp_hash_table *table, const unsigned char *str,
 	{
 	  table->collisions++;
 	  index = (index + hash2) & sizemask;
-	  node = table->entries[index];
+	  node = table->entries[index].node;
 	  if (node == NULL)
 	    break;
 
@@ -138,7 +121,7 @@ ht_lookup_with_hash (cpp_hash_table *table, const unsigned char *str,
 	      if (deleted_index != table->nslots)
 		deleted_index = index;
 	    }
-	  else if (node->hash_value == hash
+	  else if (table->entries[index].hash == hash
 		   && HT_LEN (node) == (unsigned int) len
 		   && !memcmp (HT_STR (node), str, len))
 	    return node;
@@ -153,7 +136,8 @@ ht_lookup_with_hash (cpp_hash_table *table, const unsigned char *str,
     index = deleted_index;
 
   node = (*table->alloc_node) (table);
-  table->entries[index] = node;
+  table->entries[index].node = node;
+  table->entries[index].hash = hash;
 
   HT_LEN (node) = (unsigned int) len;
   node->hash_value = hash;
@@ -181,39 +165,36 @@ ht_lookup_with_hash (cpp_hash_table *table, const unsigned char *str,
 static void
 ht_expand (cpp_hash_table *table)
 {
-  hashnode *nentries, *p, *limit;
+  struct ht_slot *nentries, *p, *limit;
   unsigned int size, sizemask;
 
   size = table->nslots * 2;
-  nentries = XCNEWVEC (hashnode, size);
+  nentries = XCNEWVEC (struct ht_slot, size);
   sizemask = size - 1;
 
   p = table->entries;
   limit = p + table->nslots;
   do
-    if (*p && *p != DELETED)
+    if (p->node && p->node != DELETED)
       {
-	unsigned int index, hash, hash2;
+	unsigned int index, hash2;
 
-	hash = (*p)->hash_value;
-	index = hash & sizemask;
+	index = p->hash & sizemask;
 
-	if (nentries[index])
+	if (nentries[index].node)
 	  {
-	    hash2 = ((hash * 17) & sizemask) | 1;
+	    hash2 = ((p->hash * 17) & sizemask) | 1;
 	    do
 	      {
 		index = (index + hash2) & sizemask;
 	      }
-	    while (nentries[index]);
+	    while (nentries[index].node);
 	  }
 	nentries[index] = *p;
       }
   while (++p < limit);
 
-  if (table->entries_owned)
-    free (table->entries);
-  table->entries_owned = true;
+  free (table->entries);
   table->entries = nentries;
   table->nslots = size;
 }
@@ -223,14 +204,14 @@ ht_expand (cpp_hash_table *table)
 void
 ht_forall (cpp_hash_table *table, ht_cb cb, const void *v)
 {
-  hashnode *p, *limit;
+  struct ht_slot *p, *limit;
 
   p = table->entries;
   limit = p + table->nslots;
   do
-    if (*p && *p != DELETED)
+    if (p->node && p->node != DELETED)
       {
-	if ((*cb) (table->pfile, *p, v) == 0)
+	if ((*cb) (table->pfile, p->node, v) == 0)
 	  break;
       }
   while (++p < limit);
@@ -241,31 +222,36 @@ ht_forall (cpp_hash_table *table, ht_cb cb, const void *v)
 void
 ht_purge (cpp_hash_table *table, ht_cb cb, const void *v)
 {
-  hashnode *p, *limit;
+  struct ht_slot *p, *limit;
 
   p = table->entries;
   limit = p + table->nslots;
   do
-    if (*p && *p != DELETED)
+    if (p->node && p->node != DELETED)
       {
-	if ((*cb) (table->pfile, *p, v))
-	  *p = DELETED;
+	if ((*cb) (table->pfile, p->node, v))
+	  p->node = DELETED;
       }
   while (++p < limit);
 }
 
-/* Restore the hash table.  */
+/* Restore the hash table from the NSLOTS nodes in ENTRIES, with hash
+   values HASHES.  */
 void
-ht_load (cpp_hash_table *ht, hashnode *entries,
-	 unsigned int nslots, unsigned int nelements,
-	 bool own)
+ht_load (cpp_hash_table *ht, hashnode *entries, unsigned int *hashes,
+	 unsigned int nslots, unsigned int nelements)
 {
-  if (ht->entries_owned)
-    free (ht->entries);
-  ht->entries = entries;
+  unsigned int i;
+
+  free (ht->entries);
+  ht->entries = XNEWVEC (struct ht_slot, nslots);
+  for (i = 0; i < nslots; i++)
+    {
+      ht->entries[i].node = entries[i];
+      ht->entries[i].hash = hashes[i];
+    }
   ht->nslots = nslots;
   ht->nelements = nelements;
-  ht->entries_owned = own;
 }
 
 /* Dump allocation statistics to stderr.  */
@@ -276,7 +262,7 @@ ht_dump_statistics (cpp_hash_table *table)
   size_t nelts, nids, overhead, headers;
   size_t total_bytes, longest, deleted = 0;
   double sum_of_squares, exp_len, exp_len2, exp2_len;
-  hashnode *p, *limit;
+  struct ht_slot *p, *limit;
 
 #define SCALE(x) ((unsigned long) ((x) < 1024*10 \
 		  ? (x) \
@@ -289,11 +275,11 @@ ht_dump_statistics (cpp_hash_table *table)
   p = table->entries;
   limit = p + table->nslots;
   do
-    if (*p == DELETED)
+    if (p->node == DELETED)
       ++deleted;
-    else if (*p)
+    else if (p->node)
       {
-	size_t n = HT_LEN (*p);
+	size_t n = HT_LEN (p->node);
 
 	total_bytes += n;
 	sum_of_squares += (double) n * n;
@@ -305,7 +291,7 @@ ht_dump_statistics (cpp_hash_table *table)
 
   nelts = table->nelements;
   overhead = obstack_memory_used (&table->stack) - total_bytes;
-  headers = table->nslots * sizeof (hashnode);
+  headers = table->nslots * sizeof (struct ht_slot);
 
   fprintf (stderr, "\nString pool\nentries\t\t%lu\n",
 	   (unsigned long) nelts);